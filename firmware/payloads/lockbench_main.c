@@ -0,0 +1,248 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/riscv_locks.h>
+#include <sbi/sbi_ecall_interface.h>
+
+/* Maximum number of HARTs taking part in the benchmark */
+#define LOCKBENCH_MAX_HARTS		32
+
+/* Highest hartid probed through SBI HSM */
+#define LOCKBENCH_MAX_HARTID		1023
+
+/* Lock acquisitions per HART in each round */
+#define LOCKBENCH_ITERATIONS		1000
+
+/* Round number telling the other HARTs to stop */
+#define LOCKBENCH_ROUND_EXIT		-1UL
+
+enum lockbench_lock_type {
+	LOCKBENCH_TICKET = 0,
+	LOCKBENCH_QUEUED,
+	LOCKBENCH_LOCK_TYPE_MAX,
+};
+
+static const char *lockbench_lock_names[LOCKBENCH_LOCK_TYPE_MAX] = {
+	"ticket",
+	"queued",
+};
+
+struct sbiret {
+	long error;
+	long value;
+};
+
+static struct sbiret sbi_ecall(unsigned long eid, unsigned long fid,
+			       unsigned long arg0, unsigned long arg1,
+			       unsigned long arg2)
+{
+	register unsigned long a0 asm("a0") = arg0;
+	register unsigned long a1 asm("a1") = arg1;
+	register unsigned long a2 asm("a2") = arg2;
+	register unsigned long a6 asm("a6") = fid;
+	register unsigned long a7 asm("a7") = eid;
+	struct sbiret ret;
+
+	asm volatile("ecall"
+		     : "+r"(a0), "+r"(a1)
+		     : "r"(a2), "r"(a6), "r"(a7)
+		     : "memory");
+	ret.error = a0;
+	ret.value = a1;
+
+	return ret;
+}
+
+static void lockbench_puts(const char *str)
+{
+	while (str && *str)
+		sbi_ecall(SBI_EXT_0_1_CONSOLE_PUTCHAR, 0, *str++, 0, 0);
+}
+
+static void lockbench_putnum(unsigned long num, int width)
+{
+	char buf[24];
+	int pos = sizeof(buf) - 1;
+
+	buf[pos] = '\0';
+	do {
+		buf[--pos] = '0' + (num % 10);
+		num /= 10;
+		width--;
+	} while (num && pos);
+	while (width-- > 0 && pos)
+		buf[--pos] = ' ';
+
+	lockbench_puts(&buf[pos]);
+}
+
+/* Locks under test and the data they protect */
+static spinlock_t ticket_lock = SPIN_LOCK_INITIALIZER;
+static qspinlock_t queued_lock = QSPIN_LOCK_INITIALIZER;
+static volatile unsigned long lockbench_counter;
+
+/* Queue nodes of the queued lock, one cache line per HART */
+static struct {
+	struct qspin_node node;
+} __aligned(64) lockbench_nodes[LOCKBENCH_MAX_HARTS];
+
+/* Round control written by the coordinator */
+static unsigned long lockbench_round;
+static unsigned long lockbench_round_harts;
+static unsigned long lockbench_round_type;
+static atomic_t lockbench_online = ATOMIC_INITIALIZER(0);
+static atomic_t lockbench_arrived = ATOMIC_INITIALIZER(0);
+static atomic_t lockbench_done = ATOMIC_INITIALIZER(0);
+
+/* Results of each HART, one cache line per HART */
+static struct {
+	unsigned long total;
+	unsigned long max;
+} __aligned(64) lockbench_result[LOCKBENCH_MAX_HARTS];
+
+static void lockbench_run(unsigned long index, unsigned long type,
+			  unsigned long harts)
+{
+	struct qspin_node *node = &lockbench_nodes[index].node;
+	unsigned long i, start, lat, total = 0, max = 0;
+
+	/* Start acquiring only once all HARTs of this round are here */
+	atomic_add_return(&lockbench_arrived, 1);
+	while (atomic_read(&lockbench_arrived) < harts)
+		cpu_relax();
+
+	for (i = 0; i < LOCKBENCH_ITERATIONS; i++) {
+		start = csr_read(CSR_TIME);
+		if (type == LOCKBENCH_TICKET)
+			spin_lock(&ticket_lock);
+		else
+			qspin_lock_node(&queued_lock, node);
+		lat = csr_read(CSR_TIME) - start;
+
+		lockbench_counter++;
+
+		if (type == LOCKBENCH_TICKET)
+			spin_unlock(&ticket_lock);
+		else
+			qspin_unlock_node(&queued_lock);
+
+		total += lat;
+		if (max < lat)
+			max = lat;
+	}
+
+	lockbench_result[index].total = total;
+	lockbench_result[index].max = max;
+	atomic_add_return(&lockbench_done, 1);
+}
+
+static void lockbench_secondary(unsigned long index)
+{
+	unsigned long round, seen = 0;
+
+	atomic_add_return(&lockbench_online, 1);
+
+	while (1) {
+		while ((round = __smp_load_acquire(&lockbench_round)) == seen)
+			cpu_relax();
+		if (round == LOCKBENCH_ROUND_EXIT)
+			break;
+		seen = round;
+
+		if (index < lockbench_round_harts)
+			lockbench_run(index, lockbench_round_type,
+				      lockbench_round_harts);
+	}
+
+	sbi_ecall(SBI_EXT_HSM, SBI_EXT_HSM_HART_STOP, 0, 0, 0);
+}
+
+static unsigned long lockbench_start_harts(unsigned long boot_hartid)
+{
+	extern char _start_secondary[];
+	unsigned long hartid, harts = 1;
+	struct sbiret ret;
+
+	for (hartid = 0; hartid <= LOCKBENCH_MAX_HARTID; hartid++) {
+		if (harts == LOCKBENCH_MAX_HARTS)
+			break;
+		if (hartid == boot_hartid)
+			continue;
+
+		ret = sbi_ecall(SBI_EXT_HSM, SBI_EXT_HSM_HART_GET_STATUS,
+				hartid, 0, 0);
+		if (ret.error || ret.value != SBI_HSM_STATE_STOPPED)
+			continue;
+
+		ret = sbi_ecall(SBI_EXT_HSM, SBI_EXT_HSM_HART_START, hartid,
+				(unsigned long)_start_secondary, harts);
+		if (!ret.error)
+			harts++;
+	}
+
+	/* Wait for the started HARTs to come online */
+	while (atomic_read(&lockbench_online) < harts - 1)
+		cpu_relax();
+
+	return harts;
+}
+
+static void lockbench_round_run(unsigned long type, unsigned long harts)
+{
+	unsigned long i, total = 0, max = 0;
+
+	lockbench_round_type = type;
+	lockbench_round_harts = harts;
+	atomic_write(&lockbench_arrived, 0);
+	atomic_write(&lockbench_done, 0);
+	__smp_store_release(&lockbench_round, lockbench_round + 1);
+
+	lockbench_run(0, type, harts);
+	while (atomic_read(&lockbench_done) < harts)
+		cpu_relax();
+
+	for (i = 0; i < harts; i++) {
+		total += lockbench_result[i].total;
+		if (max < lockbench_result[i].max)
+			max = lockbench_result[i].max;
+	}
+
+	lockbench_puts(lockbench_lock_names[type]);
+	lockbench_putnum(harts, 8);
+	lockbench_putnum(total / (harts * LOCKBENCH_ITERATIONS), 12);
+	lockbench_putnum(max, 12);
+	lockbench_puts("\n");
+}
+
+void lockbench_main(unsigned long hartid, unsigned long index)
+{
+	unsigned long type, harts, nharts;
+
+	if (index) {
+		lockbench_secondary(index);
+		return;
+	}
+
+	lockbench_puts("\nLock contention benchmark payload\n");
+	nharts = lockbench_start_harts(hartid);
+
+	lockbench_puts("Acquire latency in timer ticks over ");
+	lockbench_putnum(LOCKBENCH_ITERATIONS, 0);
+	lockbench_puts(" acquisitions per HART\n");
+	lockbench_puts("lock     harts         avg         max\n");
+
+	for (type = 0; type < LOCKBENCH_LOCK_TYPE_MAX; type++) {
+		for (harts = 1; harts <= nharts; harts++)
+			lockbench_round_run(type, harts);
+	}
+
+	__smp_store_release(&lockbench_round, LOCKBENCH_ROUND_EXIT);
+	lockbench_puts("Lock contention benchmark done\n");
+}
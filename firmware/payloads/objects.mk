@@ -17,3 +17,14 @@ test-y += test_main.o
 
 %/test.dep: $(foreach dep,$(test-y:.o=.dep),%/$(dep))
 	$(call merge_deps,$@,$^)
+
+firmware-bins-$(FW_PAYLOAD) += payloads/lockbench.bin
+
+lockbench-y += lockbench_head.o
+lockbench-y += lockbench_main.o
+
+%/lockbench.o: $(foreach obj,$(lockbench-y),%/$(obj))
+	$(call merge_objs,$@,$^)
+
+%/lockbench.dep: $(foreach dep,$(lockbench-y:.o=.dep),%/$(dep))
+	$(call merge_deps,$@,$^)
@@ -38,6 +38,10 @@ unsigned int atomic_raw_xchg_uint(volatile unsigned int *ptr,
 
 unsigned long atomic_raw_xchg_ulong(volatile unsigned long *ptr,
 				    unsigned long newval);
+
+unsigned long atomic_raw_cmpxchg_ulong(volatile unsigned long *ptr,
+				       unsigned long oldval,
+				       unsigned long newval);
 /**
  * Set a bit in an atomic variable and return the new value.
  * @nr : Bit to set.
@@ -67,4 +71,11 @@ int atomic_raw_set_bit(int nr, volatile unsigned long *addr);
  */
 int atomic_raw_clear_bit(int nr, volatile unsigned long *addr);
 
+/**
+ * Clear a bit in any address and return whether it was set before.
+ * @nr : Bit to clear.
+ * @addr: Address to modify
+ */
+int atomic_raw_test_and_clear_bit(int nr, volatile unsigned long *addr);
+
 #endif
@@ -242,6 +242,12 @@
 #define CSR_FRM				0x002
 #define CSR_FCSR			0x003
 
+/* User Vector CSRs */
+#define CSR_VSTART			0x008
+#define CSR_VL				0xc20
+#define CSR_VTYPE			0xc21
+#define CSR_VLENB			0xc22
+
 /* User Counters/Timers */
 #define CSR_CYCLE			0xc00
 #define CSR_TIME			0xc01
@@ -819,6 +825,22 @@
 #define INSN_MATCH_C_FSWSP		0xe002
 #define INSN_MASK_C_FSWSP		0xe003
 
+/* Vector loads/stores share LOAD-FP/STORE-FP with width 0, 5, 6 or 7 */
+#define INSN_MASK_VECTOR_LOAD_STORE	0x7f
+#define INSN_MATCH_VECTOR_LOAD		0x07
+#define INSN_MATCH_VECTOR_STORE		0x27
+
+#define IS_VECTOR_LOAD_STORE(insn)	\
+	((((insn) & INSN_MASK_VECTOR_LOAD_STORE) == INSN_MATCH_VECTOR_LOAD || \
+	  ((insn) & INSN_MASK_VECTOR_LOAD_STORE) == INSN_MATCH_VECTOR_STORE) && \
+	 (((insn) >> 12) & 0x7) != 1 && (((insn) >> 12) & 0x7) != 2 && \
+	 (((insn) >> 12) & 0x7) != 3 && (((insn) >> 12) & 0x7) != 4)
+
+/* csrrs rd, time(h), x0 (i.e. rdtime and rdtimeh pseudo-instructions) */
+#define INSN_MASK_RDTIME		0xfffff07f
+#define INSN_MATCH_RDTIME		0xc0102073
+#define INSN_MATCH_RDTIMEH		0xc8102073
+
 #define INSN_MASK_WFI			0xffffff00
 #define INSN_MATCH_WFI			0x10500000
 
@@ -914,6 +936,30 @@
 					 (s32)(((insn) >> 7) & 0x1f))
 #define MASK_FUNCT3			0x7000
 
+/* Vector load/store instruction fields */
+#define GET_VD(insn)			RV_X(insn, SH_RD, 5)
+#define GET_VS2(insn)			RV_X(insn, SH_RS2, 5)
+#define GET_VWIDTH(insn)		RV_X(insn, 12, 3)
+#define GET_VUMOP(insn)			RV_X(insn, SH_RS2, 5)
+#define GET_VMASKED(insn)		(!RV_X(insn, 25, 1))
+#define GET_VMOP(insn)			RV_X(insn, 26, 2)
+#define GET_VMEW(insn)			RV_X(insn, 28, 1)
+#define GET_VNF(insn)			(RV_X(insn, 29, 3) + 1)
+
+#define VMOP_UNIT_STRIDE		0
+#define VMOP_INDEXED_UNORDERED		1
+#define VMOP_STRIDED			2
+#define VMOP_INDEXED_ORDERED		3
+
+#define VUMOP_UNIT			0x00
+#define VUMOP_WHOLE_REG			0x08
+#define VUMOP_MASK			0x0b
+#define VUMOP_FAULT_ONLY_FIRST		0x10
+
+#define VTYPE_VLMUL(vtype)		((vtype) & 0x7)
+#define VTYPE_VSEW(vtype)		(((vtype) >> 3) & 0x7)
+#define VTYPE_VILL			(1UL << (__riscv_xlen - 1))
+
 /* clang-format on */
 
 #endif
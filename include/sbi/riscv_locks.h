@@ -42,4 +42,64 @@ void spin_lock(spinlock_t *lock);
 
 void spin_unlock(spinlock_t *lock);
 
+/** Queue node of a HART waiting on (or holding) a queued spinlock */
+struct qspin_node {
+	struct qspin_node *next;
+	unsigned long locked;
+};
+
+/** Maximum number of queued spinlocks a HART can hold at the same time */
+#define QSPIN_NODES_MAX		4
+
+/** Per-HART queue nodes of queued spinlocks (kept in sbi_scratch) */
+struct qspin_nodes {
+	unsigned long used;
+	struct qspin_node node[QSPIN_NODES_MAX];
+};
+
+/**
+ * Queued (MCS) spinlock
+ *
+ * Each waiting HART spins on its own queue node instead of a shared
+ * lock word so releasing a contended lock only touches the cache line
+ * of the next waiter. The queue nodes are per-HART and live in the
+ * sbi_scratch space of the HART.
+ */
+typedef struct {
+	struct qspin_node *tail;
+	struct qspin_node *owner;
+} qspinlock_t;
+
+#define __QSPIN_LOCK_UNLOCKED	\
+	(qspinlock_t) { NULL, NULL }
+
+#define QSPIN_LOCK_INIT(x)	\
+	x = __QSPIN_LOCK_UNLOCKED
+
+#define QSPIN_LOCK_INITIALIZER	\
+	__QSPIN_LOCK_UNLOCKED
+
+#define DEFINE_QSPIN_LOCK(x)	\
+	qspinlock_t QSPIN_LOCK_INIT(x)
+
+bool qspin_lock_check(qspinlock_t *lock);
+
+bool qspin_trylock(qspinlock_t *lock);
+
+void qspin_lock(qspinlock_t *lock);
+
+void qspin_unlock(qspinlock_t *lock);
+
+/**
+ * Acquire a queued spinlock using a queue node provided by the caller
+ *
+ * This is for code which can't use the per-HART nodes in sbi_scratch,
+ * such as S-mode payloads. The node must stay valid until it is
+ * returned by qspin_unlock_node().
+ */
+void qspin_lock_node(qspinlock_t *lock, struct qspin_node *node);
+
+/** Release a queued spinlock and return the queue node of the owner */
+struct qspin_node *qspin_unlock_node(qspinlock_t *lock);
+
 #endif
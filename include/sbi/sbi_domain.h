@@ -46,6 +46,26 @@ struct sbi_domain_memregion {
 	unsigned long flags;
 };
 
+/** Get the last address (inclusive) of a memory region */
+static inline unsigned long sbi_domain_memregion_end(
+				const struct sbi_domain_memregion *reg)
+{
+	return (reg->order < __riscv_xlen) ?
+		reg->base + ((1UL << reg->order) - 1) : -1UL;
+}
+
+/** Address range of a domain along with the memory regions matching it */
+struct sbi_domain_memregion_lookup {
+	/** Start address of the address range */
+	unsigned long start;
+	/** End address (inclusive) of the address range */
+	unsigned long end;
+	/** Memory region matching M-mode accesses (NULL if none) */
+	const struct sbi_domain_memregion *mreg;
+	/** Memory region matching S-mode and U-mode accesses (NULL if none) */
+	const struct sbi_domain_memregion *sreg;
+};
+
 /** Maximum number of domains */
 #define SBI_DOMAIN_MAX_INDEX			32
 
@@ -78,6 +98,20 @@ struct sbi_domain {
 	unsigned long next_mode;
 	/** Is domain allowed to reset the system */
 	bool system_reset_allowed;
+	/** Is domain allowed to suspend the system */
+	bool system_suspend_allowed;
+	/**
+	 * Number of entries in the memory region lookup table (zero
+	 * if the lookup table is not available)
+	 * Note: This set by sbi_domain_finalize() in the coldboot path
+	 */
+	u32 lookup_count;
+	/**
+	 * Memory region lookup table sorted by address with
+	 * non-overlapping entries covering the whole address space
+	 * Note: This set by sbi_domain_finalize() in the coldboot path
+	 */
+	struct sbi_domain_memregion_lookup *lookup;
 };
 
 /** The root domain instance */
@@ -154,6 +188,21 @@ bool sbi_domain_check_addr(const struct sbi_domain *dom,
 			   unsigned long addr, unsigned long mode,
 			   unsigned long access_flags);
 
+/**
+ * Check whether we can access specified address range for given mode and
+ * memory region flags under a domain
+ * @param dom pointer to domain
+ * @param addr the start of the address range to be checked
+ * @param size the size of the address range to be checked
+ * @param mode the privilege mode of access
+ * @param access_flags bitmask of domain access types (enum sbi_domain_access)
+ * @return TRUE if access allowed otherwise FALSE
+ */
+bool sbi_domain_check_addr_range(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long size,
+				 unsigned long mode,
+				 unsigned long access_flags);
+
 /** Dump domain details on the console */
 void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix);
 
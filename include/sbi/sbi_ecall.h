@@ -11,17 +11,18 @@
 #define __SBI_ECALL_H__
 
 #include <sbi/sbi_types.h>
-#include <sbi/sbi_list.h>
 
-#define SBI_ECALL_VERSION_MAJOR		1
+#define SBI_ECALL_VERSION_MAJOR		2
 #define SBI_ECALL_VERSION_MINOR		0
 #define SBI_OPENSBI_IMPID		1
 
+/** Maximum number of extensions in the ecall dispatch table */
+#define SBI_ECALL_MAX_EXTENSIONS	32
+
 struct sbi_trap_regs;
 struct sbi_trap_info;
 
 struct sbi_ecall_extension {
-	struct sbi_dlist head;
 	unsigned long extid_start;
 	unsigned long extid_end;
 	int (* probe)(unsigned long extid, unsigned long *out_val);
@@ -29,6 +29,10 @@
 #define SBI_EXT_HSM				0x48534D
 #define SBI_EXT_SRST				0x53525354
 #define SBI_EXT_PMU				0x504D55
+#define SBI_EXT_DBCN				0x4442434E
+#define SBI_EXT_SUSP				0x53555350
+#define SBI_EXT_STA				0x535441
+#define SBI_EXT_NACL				0x4E41434C
 
 /* SBI function IDs for BASE extension*/
 #define SBI_EXT_BASE_GET_SPEC_VERSION		0x0
@@ -92,6 +96,73 @@
 #define SBI_SRST_RESET_REASON_NONE	0x0
 #define SBI_SRST_RESET_REASON_SYSFAIL	0x1
 
+/* SBI function IDs for SUSP extension */
+#define SBI_EXT_SUSP_SUSPEND			0x0
+
+#define SBI_SUSP_SLEEP_TYPE_SUSPEND		0x0
+#define SBI_SUSP_SLEEP_TYPE_LAST		SBI_SUSP_SLEEP_TYPE_SUSPEND
+#define SBI_SUSP_PLATFORM_SLEEP_START		0x80000000
+
+/* SBI function IDs for STA extension */
+#define SBI_EXT_STA_STEAL_TIME_SET_SHMEM	0x0
+
+/* SBI function IDs for NACL extension */
+#define SBI_EXT_NACL_PROBE_FEATURE		0x0
+#define SBI_EXT_NACL_SET_SHMEM			0x1
+#define SBI_EXT_NACL_SYNC_CSR			0x2
+#define SBI_EXT_NACL_SYNC_HFENCE		0x3
+#define SBI_EXT_NACL_SYNC_SRET			0x4
+
+#define SBI_NACL_FEAT_SYNC_CSR			0x0
+#define SBI_NACL_FEAT_SYNC_HFENCE		0x1
+#define SBI_NACL_FEAT_SYNC_SRET			0x2
+#define SBI_NACL_FEAT_AUTOSWAP_CSR		0x3
+
+/* NACL shared memory layout */
+#define SBI_NACL_SHMEM_SCRATCH_SIZE		0x1000
+#define SBI_NACL_SHMEM_CSR_OFFSET		SBI_NACL_SHMEM_SCRATCH_SIZE
+#define SBI_NACL_SHMEM_CSR_COUNT		1024
+#define SBI_NACL_SHMEM_SIZE			\
+	(SBI_NACL_SHMEM_SCRATCH_SIZE +		\
+	 SBI_NACL_SHMEM_CSR_COUNT * (__riscv_xlen / 8))
+#define SBI_NACL_SHMEM_HFENCE_OFFSET		0x0800
+#define SBI_NACL_SHMEM_HFENCE_SIZE		0x0780
+#define SBI_NACL_SHMEM_DBITMAP_OFFSET		0x0F80
+
+/* Index of a CSR in the NACL shared memory CSR space */
+#define SBI_NACL_SHMEM_CSR_INDEX(__csr)		\
+	((((__csr) & 0xC00) >> 2) | ((__csr) & 0xFF))
+
+/* NACL HFENCE entry: config, page number, reserved, page count */
+#define SBI_NACL_HFENCE_ENTRY_WORDS		4
+#define SBI_NACL_HFENCE_ENTRY_COUNT		\
+	(SBI_NACL_SHMEM_HFENCE_SIZE /		\
+	 (SBI_NACL_HFENCE_ENTRY_WORDS * (__riscv_xlen / 8)))
+
+#define SBI_NACL_HFENCE_CONFIG_PEND		(1UL << (__riscv_xlen - 1))
+#define SBI_NACL_HFENCE_CONFIG_TYPE_SHIFT	(__riscv_xlen - 8)
+#define SBI_NACL_HFENCE_CONFIG_TYPE_MASK	0xFUL
+#define SBI_NACL_HFENCE_CONFIG_ORDER_SHIFT	(__riscv_xlen - 16)
+#define SBI_NACL_HFENCE_CONFIG_ORDER_MASK	0x7FUL
+#if __riscv_xlen == 32
+#define SBI_NACL_HFENCE_CONFIG_VMID_SHIFT	9
+#define SBI_NACL_HFENCE_CONFIG_VMID_MASK	0x7FUL
+#define SBI_NACL_HFENCE_CONFIG_ASID_MASK	0x1FFUL
+#else
+#define SBI_NACL_HFENCE_CONFIG_VMID_SHIFT	16
+#define SBI_NACL_HFENCE_CONFIG_VMID_MASK	0x3FFFUL
+#define SBI_NACL_HFENCE_CONFIG_ASID_MASK	0xFFFFUL
+#endif
+
+#define SBI_NACL_HFENCE_TYPE_GVMA		0x0
+#define SBI_NACL_HFENCE_TYPE_GVMA_ALL		0x1
+#define SBI_NACL_HFENCE_TYPE_GVMA_VMID		0x2
+#define SBI_NACL_HFENCE_TYPE_GVMA_VMID_ALL	0x3
+#define SBI_NACL_HFENCE_TYPE_VVMA		0x4
+#define SBI_NACL_HFENCE_TYPE_VVMA_ALL		0x5
+#define SBI_NACL_HFENCE_TYPE_VVMA_ASID		0x6
+#define SBI_NACL_HFENCE_TYPE_VVMA_ASID_ALL	0x7
+
 /* SBI function IDs for PMU extension */
 #define SBI_EXT_PMU_NUM_COUNTERS	0x0
 #define SBI_EXT_PMU_COUNTER_GET_INFO	0x1
@@ -99,6 +170,14 @@
 #define SBI_EXT_PMU_COUNTER_START	0x3
 #define SBI_EXT_PMU_COUNTER_STOP	0x4
 #define SBI_EXT_PMU_COUNTER_FW_READ	0x5
+#define SBI_EXT_PMU_SNAPSHOT_SET_SHMEM	0x7
+
+/* SBI function IDs for DBCN extension */
+#define SBI_EXT_DBCN_CONSOLE_WRITE		0x0
+#define SBI_EXT_DBCN_CONSOLE_READ		0x1
+#define SBI_EXT_DBCN_CONSOLE_WRITE_BYTE		0x2
+
+#ifndef __ASSEMBLER__
 
 /** General pmu event codes specified in SBI PMU extension */
 enum sbi_pmu_hw_generic_events_t {
@@ -199,6 +278,8 @@ enum sbi_pmu_ctr_type {
 	SBI_PMU_CTR_TYPE_FW,
 };
 
+#endif
+
 /* Helper macros to decode event idx */
 #define SBI_PMU_EVENT_IDX_OFFSET 20
 #define SBI_PMU_EVENT_IDX_MASK 0xFFFFF
@@ -226,9 +307,11 @@ enum sbi_pmu_ctr_type {
 
 /* Flags defined for counter start function */
 #define SBI_PMU_START_FLAG_SET_INIT_VALUE (1 << 0)
+#define SBI_PMU_START_FLAG_INIT_SNAPSHOT (1 << 1)
 
 /* Flags defined for counter stop function */
 #define SBI_PMU_STOP_FLAG_RESET (1 << 0)
+#define SBI_PMU_STOP_FLAG_TAKE_SNAPSHOT (1 << 1)
 
 /* SBI base specification related macros */
 #define SBI_SPEC_VERSION_MAJOR_OFFSET		24
@@ -239,6 +322,20 @@ enum sbi_pmu_ctr_type {
 #define SBI_EXT_FIRMWARE_START			0x0A000000
 #define SBI_EXT_FIRMWARE_END			0x0AFFFFFF
 
+/*
+ * OpenSBI specific trap statistics extension. The low bits of firmware
+ * specific extension IDs are the SBI implementation ID.
+ */
+#define SBI_EXT_OPENSBI_TRAP_STATS		\
+	(SBI_EXT_FIRMWARE_START + SBI_OPENSBI_IMPID)
+
+#define SBI_EXT_TRAP_STATS_DUMP			0x0
+#define SBI_EXT_TRAP_STATS_RESET		0x1
+#define SBI_EXT_TRAP_STATS_READ			0x2
+
+#define SBI_TRAP_STATS_FIELD_COUNT		0x0
+#define SBI_TRAP_STATS_FIELD_CYCLES		0x1
+
 /* SBI return error codes */
 #define SBI_SUCCESS				0
 #define SBI_ERR_FAILED				-1
@@ -249,8 +346,9 @@ enum sbi_pmu_ctr_type {
 #define SBI_ERR_ALREADY_AVAILABLE		-6
 #define SBI_ERR_ALREADY_STARTED			-7
 #define SBI_ERR_ALREADY_STOPPED			-8
+#define SBI_ERR_NO_SHMEM			-9
 
-#define SBI_LAST_ERR				SBI_ERR_ALREADY_STOPPED
+#define SBI_LAST_ERR				SBI_ERR_NO_SHMEM
 
 /* clang-format on */
 
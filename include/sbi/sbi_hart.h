@@ -10,6 +10,7 @@
 #ifndef __SBI_HART_H__
 #define __SBI_HART_H__
 
+#include <sbi/sbi_scratch.h>
 #include <sbi/sbi_types.h>
 
 /** Possible privileged specification versions of a hart */
@@ -41,6 +42,16 @@ enum sbi_hart_extensions {
 	SBI_HART_EXT_MAX,
 };
 
+/** Per-HART flags cached for trap and timer fast paths */
+enum sbi_hart_fast_flags {
+	/** HART has AIA M-mode CSRs */
+	SBI_HART_FAST_SMAIA = (1 << 0),
+	/** HART has Sstc extension */
+	SBI_HART_FAST_SSTC = (1 << 1),
+	/** HART has hypervisor extension */
+	SBI_HART_FAST_HEXT = (1 << 2),
+};
+
 struct sbi_hart_features {
 	bool detected;
 	int priv_version;
@@ -57,6 +68,18 @@ struct sbi_scratch;
 int sbi_hart_reinit(struct sbi_scratch *scratch);
 int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot);
 
+/**
+ * Get cached fast path flags of current HART
+ *
+ * The flags live in struct sbi_scratch and are cleared by the firmware
+ * before the first trap so this is safe to call even before
+ * sbi_hart_init() has detected the HART features.
+ */
+static inline unsigned long sbi_hart_fast_flags(void)
+{
+	return sbi_scratch_thishart_ptr()->fast_flags;
+}
+
 extern void (*sbi_hart_expected_trap)(void);
 static inline ulong sbi_hart_expected_trap_addr(void)
 {
@@ -11,6 +11,7 @@
 #define __SBI_IPI_H__
 
 #include <sbi/sbi_types.h>
+#include <sbi/sbi_hartmask.h>
 
 /* clang-format off */
 
@@ -26,6 +27,13 @@ struct sbi_ipi_device {
 	/** Send IPI to a target HART */
 	void (*ipi_send)(u32 target_hart);
 
+	/**
+	 * Send IPI to all HARTs in a hartmask
+	 * Note: This is an optional callback and it is used instead of
+	 * ipi_send() for multiple target HARTs when available.
+	 */
+	void (*ipi_send_mask)(const struct sbi_hartmask *target_mask);
+
 	/** Clear IPI for a target HART */
 	void (*ipi_clear)(u32 target_hart);
 };
@@ -47,9 +55,9 @@ struct sbi_ipi_event_ops {
 			u32 remote_hartid, void *data);
 
 	/**
-	 * Sync callback to wait for remote HART
-	 * Note: This is an optional callback and it is called just after
-	 * triggering IPI to remote HART.
+	 * Sync callback to wait for remote HARTs
+	 * Note: This is an optional callback and it is called only once
+	 * after triggering IPI to all remote HARTs.
 	 */
 	void (* sync)(struct sbi_scratch *scratch);
 
@@ -77,6 +85,8 @@ void sbi_ipi_process(void);
 
 int sbi_ipi_raw_send(u32 target_hart);
 
+int sbi_ipi_raw_send_mask(const struct sbi_hartmask *target_mask);
+
 const struct sbi_ipi_device *sbi_ipi_get_device(void);
 
 void sbi_ipi_set_device(const struct sbi_ipi_device *dev);
@@ -10,8 +10,10 @@
 #ifndef __SBI_MISALIGNED_LDST_H__
 #define __SBI_MISALIGNED_LDST_H__
 
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_types.h>
 
+struct sbi_scratch;
 struct sbi_trap_regs;
 
 int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
@@ -20,4 +22,20 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 				 struct sbi_trap_regs *regs);
 
+#ifdef OPENSBI_CC_SUPPORT_VECTOR
+
+int sbi_misaligned_v_ldst_emulate(ulong insn, struct sbi_trap_regs *regs);
+
+#else
+
+static inline int sbi_misaligned_v_ldst_emulate(ulong insn,
+						struct sbi_trap_regs *regs)
+{
+	return SBI_ENOTSUPP;
+}
+
+#endif
+
+int sbi_misaligned_ldst_init(struct sbi_scratch *scratch, bool cold_boot);
+
 #endif
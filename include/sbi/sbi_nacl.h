@@ -0,0 +1,27 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#ifndef __SBI_NACL_H__
+#define __SBI_NACL_H__
+
+#include <sbi/sbi_types.h>
+
+struct sbi_scratch;
+
+#ifdef CONFIG_SBI_ECALL_NACL
+
+int sbi_nacl_init(struct sbi_scratch *scratch, bool cold_boot);
+
+#else
+
+static inline int sbi_nacl_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+
+#endif
+
+#endif
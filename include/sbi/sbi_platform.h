@@ -38,6 +38,8 @@
 
 #define SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT		(1UL << 12)
 
+#define SBI_PLATFORM_TLB_NUM_ENTRIES_DEFAULT			8
+
 #ifndef __ASSEMBLER__
 
 #include <sbi/sbi_ecall_interface.h>
@@ -118,6 +120,9 @@ struct sbi_platform_operations {
 	/** Get tlb flush limit value **/
 	u64 (*get_tlbr_flush_limit)(void);
 
+	/** Get number of entries in per-HART tlb request queue **/
+	u32 (*get_tlb_num_entries)(void);
+
 	/** Initialize platform timer for current HART */
 	int (*timer_init)(bool cold_boot);
 	/** Exit platform timer for current HART */
@@ -310,6 +315,22 @@ static inline u64 sbi_platform_tlbr_flush_limit(const struct sbi_platform *plat)
 	return SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT;
 }
 
+/**
+ * Get number of entries in the per-HART tlb request queue. The value is
+ * rounded up to a power of two by the tlb request queue.
+ *
+ * @param plat pointer to struct sbi_platform
+ *
+ * @return number of tlb queue entries. Returns a default if not defined
+ * by platform.
+ */
+static inline u32 sbi_platform_tlb_num_entries(const struct sbi_platform *plat)
+{
+	if (plat && sbi_platform_ops(plat)->get_tlb_num_entries)
+		return sbi_platform_ops(plat)->get_tlb_num_entries();
+	return SBI_PLATFORM_TLB_NUM_ENTRIES_DEFAULT;
+}
+
 /**
  * Get total number of HARTs supported by the platform
  *
@@ -0,0 +1,50 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#ifndef __SBI_RING_H__
+#define __SBI_RING_H__
+
+#include <sbi/sbi_types.h>
+
+/**
+ * Lock-free multi-producer single-consumer ring
+ *
+ * Every slot starts with a sequence word followed by the entry data.
+ * Producers reserve a slot by advancing the head with compare-exchange
+ * and publish the entry by updating the sequence word of the slot. The
+ * only consumer publishes a free slot the same way so producers and the
+ * consumer never share a lock.
+ */
+struct sbi_ring {
+	void *queue;
+	volatile unsigned long head;
+	volatile unsigned long tail;
+	u16 entry_size;
+	u16 num_entries;
+};
+
+enum sbi_ring_inplace_update_types {
+	SBI_RING_SKIP,
+	SBI_RING_UPDATED,
+	SBI_RING_UNCHANGED,
+};
+
+/** Size of one ring slot for given entry size */
+#define SBI_RING_SLOT_SIZE(__entry_size)	\
+	(__SIZEOF_POINTER__ + ROUNDUP(__entry_size, __SIZEOF_POINTER__))
+
+/** Size of ring memory for given number of entries and entry size */
+#define SBI_RING_MEM_SIZE(__entries, __entry_size)	\
+	((__entries) * SBI_RING_SLOT_SIZE(__entry_size))
+
+int sbi_ring_init(struct sbi_ring *ring, void *queue_mem, u16 entries,
+		  u16 entry_size);
+int sbi_ring_enqueue(struct sbi_ring *ring, void *data);
+int sbi_ring_dequeue(struct sbi_ring *ring, void *data);
+int sbi_ring_inplace_update(struct sbi_ring *ring, void *in,
+			    int (*fptr)(void *in, void *data));
+
+#endif
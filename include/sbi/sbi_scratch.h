@@ -36,8 +36,14 @@
 #define SBI_SCRATCH_TMP0_OFFSET			(9 * __SIZEOF_POINTER__)
 /** Offset of options member in sbi_scratch */
 #define SBI_SCRATCH_OPTIONS_OFFSET		(10 * __SIZEOF_POINTER__)
+/** Offset of fast_flags member in sbi_scratch */
+#define SBI_SCRATCH_FAST_FLAGS_OFFSET		(11 * __SIZEOF_POINTER__)
+/** Offset of queued spinlock nodes in sbi_scratch */
+#define SBI_SCRATCH_QSPIN_NODES_OFFSET		(12 * __SIZEOF_POINTER__)
+/** Size of queued spinlock nodes in sbi_scratch */
+#define SBI_SCRATCH_QSPIN_NODES_SIZE		(9 * __SIZEOF_POINTER__)
 /** Offset of extra space in sbi_scratch */
-#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(11 * __SIZEOF_POINTER__)
+#define SBI_SCRATCH_EXTRA_SPACE_OFFSET		(21 * __SIZEOF_POINTER__)
 /** Maximum size of sbi_scratch (4KB) */
 #define SBI_SCRATCH_SIZE			(0x1000)
 
@@ -71,6 +77,8 @@ struct sbi_scratch {
 	unsigned long tmp0;
 	/** Options for OpenSBI library */
 	unsigned long options;
+	/** Cached fast path flags of this HART */
+	unsigned long fast_flags;
 };
 
 /**
@@ -132,6 +140,11 @@ _Static_assert(
 		== SBI_SCRATCH_OPTIONS_OFFSET,
 	"struct sbi_scratch definition has changed, please redefine "
 	"SBI_SCRATCH_OPTIONS_OFFSET");
+_Static_assert(
+	offsetof(struct sbi_scratch, fast_flags)
+		== SBI_SCRATCH_FAST_FLAGS_OFFSET,
+	"struct sbi_scratch definition has changed, please redefine "
+	"SBI_SCRATCH_FAST_FLAGS_OFFSET");
 
 /** Possible options for OpenSBI library */
 enum sbi_scratch_options {
@@ -0,0 +1,57 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#ifndef __SBI_STA_H__
+#define __SBI_STA_H__
+
+#include <sbi/sbi_types.h>
+
+struct sbi_scratch;
+struct sbi_trap_regs;
+
+#ifdef CONFIG_SBI_ECALL_STA
+
+/** Steal-time record shared with S-mode as defined by SBI STA extension */
+struct sbi_sta_struct {
+	/* Odd while the record is being updated */
+	u32 sequence;
+	u32 flags;
+	/* Accumulated steal time in nanoseconds */
+	u64 steal;
+	/* Non-zero when the HART is not running S-mode */
+	u8 preempted;
+	u8 pad[47];
+} __packed;
+
+#define SBI_STA_SHMEM_SIZE	sizeof(struct sbi_sta_struct)
+
+int sbi_sta_init(struct sbi_scratch *scratch, bool cold_boot);
+
+void sbi_sta_steal_time_add(u32 hartid, u64 delta_ns);
+
+void sbi_sta_set_preempted(u32 hartid, bool preempted);
+
+u64 sbi_sta_irq_enter(const struct sbi_trap_regs *regs);
+
+void sbi_sta_irq_exit(u64 start);
+
+#else
+
+static inline int sbi_sta_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	return 0;
+}
+static inline void sbi_sta_steal_time_add(u32 hartid, u64 delta_ns) { }
+static inline void sbi_sta_set_preempted(u32 hartid, bool preempted) { }
+static inline u64 sbi_sta_irq_enter(const struct sbi_trap_regs *regs)
+{
+	return 0;
+}
+static inline void sbi_sta_irq_exit(u64 start) { }
+
+#endif
+
+#endif
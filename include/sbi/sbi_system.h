@@ -43,4 +43,35 @@ bool sbi_system_reset_supported(u32 reset_type, u32 reset_reason);
 
 void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason);
 
+/** System suspend device */
+struct sbi_system_suspend_device {
+	/** Name of the system suspend device */
+	char name[32];
+
+	/* Check whether sleep type is supported by the device */
+	int (*system_suspend_check)(u32 sleep_type);
+
+	/**
+	 * Suspend the system (e.g. suspend-to-RAM)
+	 *
+	 * The device may resume the system at mmode_resume_addr, which is
+	 * the warm boot entry point, instead of returning. A return value
+	 * of 0 means the system was suspended and has resumed.
+	 */
+	int (*system_suspend)(u32 sleep_type, unsigned long mmode_resume_addr);
+
+	/** Restore platform state lost while the system was suspended */
+	void (*system_resume)(void);
+};
+
+const struct sbi_system_suspend_device *sbi_system_suspend_get_device(void);
+
+void sbi_system_suspend_set_device(const struct sbi_system_suspend_device *dev);
+
+bool sbi_system_suspend_supported(u32 sleep_type);
+
+int sbi_system_suspend(u32 sleep_type, ulong resume_addr, ulong opaque);
+
+void sbi_system_resume(void);
+
 #endif
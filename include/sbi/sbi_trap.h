@@ -229,6 +229,8 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 
 struct sbi_trap_regs *sbi_trap_handler(struct sbi_trap_regs *regs);
 
+struct sbi_trap_regs *sbi_trap_handler_fast(struct sbi_trap_regs *regs);
+
 void __noreturn sbi_trap_exit(const struct sbi_trap_regs *regs);
 
 #endif
@@ -0,0 +1,46 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#ifndef __SBI_TRAP_STATS_H__
+#define __SBI_TRAP_STATS_H__
+
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_types.h>
+
+struct sbi_ecall_extension;
+
+#ifdef CONFIG_SBI_TRAP_STATS
+
+/** Get the start timestamp of a trap or ecall */
+static inline ulong sbi_trap_stats_start(void)
+{
+	return csr_read(CSR_MCYCLE);
+}
+
+void sbi_trap_stats_record_trap(ulong mcause, ulong start);
+
+void sbi_trap_stats_record_ecall(int slot,
+				 const struct sbi_ecall_extension *ext,
+				 ulong funcid, ulong start);
+
+int sbi_trap_stats_read(u32 hartid, ulong mcause, ulong field,
+			unsigned long *out_val);
+
+void sbi_trap_stats_reset(void);
+
+void sbi_trap_stats_dump(void);
+
+#else
+
+static inline ulong sbi_trap_stats_start(void) { return 0; }
+static inline void sbi_trap_stats_record_trap(ulong mcause, ulong start) { }
+static inline void sbi_trap_stats_record_ecall(int slot,
+				const struct sbi_ecall_extension *ext,
+				ulong funcid, ulong start) { }
+
+#endif
+
+#endif
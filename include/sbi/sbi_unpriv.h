@@ -36,6 +36,22 @@ DECLARE_UNPRIVILEGED_LOAD_FUNCTION(u64)
 DECLARE_UNPRIVILEGED_STORE_FUNCTION(u64)
 DECLARE_UNPRIVILEGED_LOAD_FUNCTION(ulong)
 
+/**
+ * Load up to sizeof(ulong) bytes from a possibly misaligned address
+ * using a single MPRV window. Bytes are merged in little-endian order
+ * into val. Returns the number of bytes loaded before a trap (if any).
+ */
+ulong sbi_load_bytes(const u8 *addr, ulong len, ulong *val,
+		     struct sbi_trap_info *trap);
+
+/**
+ * Store up to sizeof(ulong) bytes of val in little-endian order to a
+ * possibly misaligned address using a single MPRV window. Returns the
+ * number of bytes stored before a trap (if any).
+ */
+ulong sbi_store_bytes(u8 *addr, ulong len, ulong val,
+		      struct sbi_trap_info *trap);
+
 ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap);
 
 #endif
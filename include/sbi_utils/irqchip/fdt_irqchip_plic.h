@@ -28,6 +28,21 @@ void fdt_plic_context_save(bool smode, u32 *enable, u32 *threshold, u32 num);
 void fdt_plic_context_restore(bool smode, const u32 *enable, u32 threshold,
 			      u32 num);
 
+#ifdef CONFIG_FDT_IRQCHIP_PLIC
+
+/** Save the PLIC state of the HART suspending the system */
+void fdt_plic_suspend(void);
+
+/** Restore the PLIC state saved by fdt_plic_suspend() */
+void fdt_plic_resume(void);
+
+#else
+
+static inline void fdt_plic_suspend(void) { }
+static inline void fdt_plic_resume(void) { }
+
+#endif
+
 void thead_plic_restore(void);
 
 #endif
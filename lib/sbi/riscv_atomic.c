@@ -206,6 +206,18 @@ unsigned long atomic_raw_xchg_ulong(volatile unsigned long *ptr,
 #endif
 }
 
+unsigned long atomic_raw_cmpxchg_ulong(volatile unsigned long *ptr,
+				       unsigned long oldval,
+				       unsigned long newval)
+{
+	/* Atomically set new value if old value matches and return old value */
+#ifdef __riscv_atomic
+	return __sync_val_compare_and_swap(ptr, oldval, newval);
+#else
+	return cmpxchg(ptr, oldval, newval);
+#endif
+}
+
 #if (__SIZEOF_POINTER__ == 8)
 #define __AMO(op) "amo" #op ".d"
 #elif (__SIZEOF_POINTER__ == 4)
@@ -242,6 +254,13 @@ inline int atomic_raw_clear_bit(int nr, volatile unsigned long *addr)
 	return __atomic_op_bit(and, __NOT, nr, addr);
 }
 
+inline int atomic_raw_test_and_clear_bit(int nr, volatile unsigned long *addr)
+{
+	unsigned long old = __atomic_op_bit(and, __NOT, nr, addr);
+
+	return (old & BIT_MASK(nr)) ? 1 : 0;
+}
+
 inline int atomic_set_bit(int nr, atomic_t *atom)
 {
 	return atomic_raw_set_bit(nr, (unsigned long *)&atom->counter);
@@ -5,8 +5,11 @@
  * Copyright (c) 2021 Christoph Müllner <cmuellner@linux.com>
  */
 
+#include <sbi/riscv_atomic.h>
 #include <sbi/riscv_barrier.h>
 #include <sbi/riscv_locks.h>
+#include <sbi/sbi_hart.h>
+#include <sbi/sbi_scratch.h>
 
 static inline bool spin_lock_unlocked(spinlock_t lock)
 {
@@ -75,3 +78,113 @@ void spin_unlock(spinlock_t *lock)
 {
 	__smp_store_release(&lock->owner, lock->owner + 1);
 }
+
+_Static_assert(sizeof(struct qspin_nodes) == SBI_SCRATCH_QSPIN_NODES_SIZE,
+	       "struct qspin_nodes definition has changed, please redefine "
+	       "SBI_SCRATCH_QSPIN_NODES_SIZE");
+
+static struct qspin_node *qspin_node_get(void)
+{
+	struct qspin_nodes *hn =
+		sbi_scratch_thishart_offset_ptr(SBI_SCRATCH_QSPIN_NODES_OFFSET);
+	int i;
+
+	for (i = 0; i < QSPIN_NODES_MAX; i++) {
+		if (!(hn->used & (1UL << i)))
+			break;
+	}
+
+	/* Running out of queue nodes means locks are nested too deep */
+	if (i == QSPIN_NODES_MAX)
+		sbi_hart_hang();
+
+	hn->used |= 1UL << i;
+
+	return &hn->node[i];
+}
+
+static void qspin_node_put(struct qspin_node *node)
+{
+	struct qspin_nodes *hn =
+		sbi_scratch_thishart_offset_ptr(SBI_SCRATCH_QSPIN_NODES_OFFSET);
+
+	hn->used &= ~(1UL << (node - hn->node));
+}
+
+bool qspin_lock_check(qspinlock_t *lock)
+{
+	RISCV_FENCE(r, rw);
+	return lock->tail ? true : false;
+}
+
+bool qspin_trylock(qspinlock_t *lock)
+{
+	struct qspin_node *node = qspin_node_get();
+
+	node->next = NULL;
+	node->locked = 0;
+
+	if (atomic_raw_cmpxchg_ulong((unsigned long *)&lock->tail,
+				     0, (unsigned long)node)) {
+		qspin_node_put(node);
+		return false;
+	}
+
+	lock->owner = node;
+	return true;
+}
+
+void qspin_lock_node(qspinlock_t *lock, struct qspin_node *node)
+{
+	struct qspin_node *prev;
+
+	node->next = NULL;
+	node->locked = 0;
+
+	/* Append our node to the queue */
+	prev = (struct qspin_node *)atomic_raw_xchg_ulong(
+				(unsigned long *)&lock->tail,
+				(unsigned long)node);
+
+	/* If there was a previous waiter then wait for it to hand over */
+	if (prev) {
+		__smp_store_release(&prev->next, node);
+		while (!__smp_load_acquire(&node->locked))
+			cpu_relax();
+	}
+
+	lock->owner = node;
+}
+
+void qspin_lock(qspinlock_t *lock)
+{
+	qspin_lock_node(lock, qspin_node_get());
+}
+
+struct qspin_node *qspin_unlock_node(qspinlock_t *lock)
+{
+	struct qspin_node *next, *node = lock->owner;
+
+	next = __smp_load_acquire(&node->next);
+	if (!next) {
+		/* No known successor so try to mark the lock free */
+		if (atomic_raw_cmpxchg_ulong((unsigned long *)&lock->tail,
+					     (unsigned long)node, 0) ==
+		    (unsigned long)node)
+			goto done;
+
+		/* A successor is queueing so wait for it to link up */
+		while (!(next = __smp_load_acquire(&node->next)))
+			cpu_relax();
+	}
+
+	__smp_store_release(&next->locked, 1);
+
+done:
+	return node;
+}
+
+void qspin_unlock(qspinlock_t *lock)
+{
+	qspin_node_put(qspin_unlock_node(lock));
+}
@@ -7,14 +7,31 @@
  *   Anup Patel <anup.patel@wdc.com>
  */
 
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_barrier.h>
 #include <sbi/riscv_locks.h>
 #include <sbi/sbi_console.h>
+#include <sbi/sbi_domain.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
 
 static const struct sbi_console_device *console_dev = NULL;
-static spinlock_t console_out_lock	       = SPIN_LOCK_INITIALIZER;
+static qspinlock_t console_out_lock	       = QSPIN_LOCK_INITIALIZER;
+
+#ifdef CONFIG_SBI_CONSOLE_BUFFER
+#define CONSOLE_RING_SIZE	4096
+
+/* Console output of all HARTs waiting to be written to the device */
+static char console_ring[CONSOLE_RING_SIZE];
+/* Free running write index, only updated with console_out_lock held */
+static unsigned long console_ring_head;
+/* Free running read index, only updated by the draining HART */
+static unsigned long console_ring_tail;
+/* Non-zero while a HART is draining the ring to the device */
+static unsigned long console_ring_draining;
+#endif
 
 bool sbi_isprintable(char c)
 {
@@ -32,23 +49,143 @@ int sbi_getc(void)
 	return -1;
 }
 
-void sbi_putc(char ch)
+static unsigned long console_dev_puts(const char *str, unsigned long len)
+{
+	unsigned long i;
+
+	if (console_dev->console_puts)
+		return console_dev->console_puts(str, len);
+
+	for (i = 0; i < len; i++)
+		console_dev->console_putc(str[i]);
+
+	return len;
+}
+
+#ifdef CONFIG_SBI_CONSOLE_BUFFER
+
+static void console_ring_drain(void)
+{
+	unsigned long head, tail, len;
+
+	do {
+		/* Somebody else is writing the ring to the device */
+		if (atomic_raw_xchg_ulong(&console_ring_draining, 1))
+			return;
+
+		tail = console_ring_tail;
+		while (tail != (head = __smp_load_acquire(&console_ring_head))) {
+			len = CONSOLE_RING_SIZE -
+			      (tail & (CONSOLE_RING_SIZE - 1));
+			if (head - tail < len)
+				len = head - tail;
+			tail += console_dev_puts(
+				&console_ring[tail & (CONSOLE_RING_SIZE - 1)],
+				len);
+			__smp_store_release(&console_ring_tail, tail);
+		}
+
+		/*
+		 * Output added after the ring was found empty is drained
+		 * either by us or by the HART which wrote it.
+		 */
+		__smp_store_release(&console_ring_draining, 0);
+		smp_mb();
+	} while (__smp_load_acquire(&console_ring_head) != tail);
+}
+
+static void console_write_one(char ch)
 {
-	if (console_dev && console_dev->console_putc) {
-		if (ch == '\n')
-			console_dev->console_putc('\r');
-		console_dev->console_putc(ch);
+	unsigned long head = console_ring_head;
+
+	while (CONSOLE_RING_SIZE <=
+	       head - __smp_load_acquire(&console_ring_tail)) {
+		console_ring_drain();
+		cpu_relax();
 	}
+
+	console_ring[head & (CONSOLE_RING_SIZE - 1)] = ch;
+	__smp_store_release(&console_ring_head, head + 1);
 }
 
-void sbi_puts(const char *str)
+#else
+
+static void console_write_one(char ch)
+{
+	console_dev_puts(&ch, 1);
+}
+
+#endif
+
+/* Must be called with console_out_lock held */
+static void console_write(const char *str, unsigned long len)
+{
+	unsigned long i, j, seg;
+
+	if (!console_dev || (!console_dev->console_putc &&
+			     !console_dev->console_puts))
+		return;
+
+	for (i = 0; i < len; i += seg) {
+		/* Find the next run of characters without a newline */
+		for (seg = 0; i + seg < len; seg++)
+			if (str[i + seg] == '\n')
+				break;
+#ifdef CONFIG_SBI_CONSOLE_BUFFER
+		for (j = 0; j < seg; j++)
+			console_write_one(str[i + j]);
+#else
+		for (j = 0; j < seg;)
+			j += console_dev_puts(&str[i + j], seg - j);
+#endif
+		if (i + seg < len) {
+			console_write_one('\r');
+			console_write_one('\n');
+			seg++;
+		}
+	}
+}
+
+static void console_out_unlock(void)
 {
-	spin_lock(&console_out_lock);
-	while (*str) {
-		sbi_putc(*str);
-		str++;
+	qspin_unlock(&console_out_lock);
+#ifdef CONFIG_SBI_CONSOLE_BUFFER
+	console_ring_drain();
+#endif
+}
+
+void sbi_console_flush(void)
+{
+#ifdef CONFIG_SBI_CONSOLE_BUFFER
+	while (__smp_load_acquire(&console_ring_tail) !=
+	       __smp_load_acquire(&console_ring_head)) {
+		console_ring_drain();
+		cpu_relax();
 	}
-	spin_unlock(&console_out_lock);
+#endif
+}
+
+void sbi_putc(char ch)
+{
+	qspin_lock(&console_out_lock);
+	console_write(&ch, 1);
+	console_out_unlock();
+}
+
+void sbi_puts(const char *str)
+{
+	qspin_lock(&console_out_lock);
+	console_write(str, sbi_strlen(str));
+	console_out_unlock();
+}
+
+unsigned long sbi_nputs(const char *str, unsigned long len)
+{
+	qspin_lock(&console_out_lock);
+	console_write(str, len);
+	console_out_unlock();
+
+	return len;
 }
 
 void sbi_gets(char *s, int maxwidth, char endchar)
@@ -64,79 +201,117 @@ void sbi_gets(char *s, int maxwidth, char endchar)
 	*retval = '\0';
 }
 
+unsigned long sbi_ngets(char *str, unsigned long len)
+{
+	int ch;
+	unsigned long i;
+
+	for (i = 0; i < len; i++) {
+		ch = sbi_getc();
+		if (ch < 0)
+			break;
+		str[i] = ch;
+	}
+
+	return i;
+}
+
 #define PAD_RIGHT 1
 #define PAD_ZERO 2
 #define PAD_ALTERNATE 4
-#define PRINT_BUF_LEN 64
+/* Enough for a 64-bit number in decimal or hex with sign or prefix */
+#define PRINT_BUF_LEN 24
+/* Size of on-stack buffer used to render console output */
+#define PRINT_CONSOLE_BUF_LEN 128
 
 #define va_start(v, l) __builtin_va_start((v), l)
 #define va_end __builtin_va_end
 #define va_arg __builtin_va_arg
 typedef __builtin_va_list va_list;
 
-static void printc(char **out, u32 *out_len, char ch)
+/** Output of the format engine */
+struct print_out {
+	/* Output string or buffer of pending console output */
+	char *buf;
+	/* Number of characters in buf */
+	u32 pos;
+	/* Number of characters buf can hold */
+	u32 size;
+	/* Flush a full buf to console instead of dropping characters */
+	bool console;
+};
+
+static void print_flush(struct print_out *po)
 {
-	if (!out) {
-		sbi_putc(ch);
-		return;
-	}
+	console_write(po->buf, po->pos);
+	po->pos = 0;
+}
 
-	/*
-	 * The *printf entry point functions have enforced that (*out) can
-	 * only be null when out_len is non-null and its value is zero.
-	 */
-	if (!out_len || *out_len > 1) {
-		*(*out)++ = ch;
-		**out = '\0';
+static inline void printc(struct print_out *po, char ch)
+{
+	if (unlikely(po->pos == po->size)) {
+		if (!po->console)
+			return;
+		print_flush(po);
 	}
 
-	if (out_len && *out_len > 0)
-		--(*out_len);
+	po->buf[po->pos++] = ch;
 }
 
-static int prints(char **out, u32 *out_len, const char *string, int width,
-		  int flags)
+static void printn(struct print_out *po, const char *str, u32 len)
 {
-	int pc	     = 0;
-	char padchar = ' ';
-
-	if (width > 0) {
-		int len = 0;
-		const char *ptr;
-		for (ptr = string; *ptr; ++ptr)
-			++len;
-		if (len >= width)
-			width = 0;
-		else
-			width -= len;
-		if (flags & PAD_ZERO)
-			padchar = '0';
-	}
-	if (!(flags & PAD_RIGHT)) {
-		for (; width > 0; --width) {
-			printc(out, out_len, padchar);
-			++pc;
+	u32 n;
+
+	while (len) {
+		if (po->pos == po->size) {
+			if (!po->console)
+				return;
+			print_flush(po);
 		}
+
+		n = po->size - po->pos;
+		if (len < n)
+			n = len;
+		sbi_memcpy(&po->buf[po->pos], str, n);
+		po->pos += n;
+		str += n;
+		len -= n;
 	}
-	for (; *string; ++string) {
-		printc(out, out_len, *string);
-		++pc;
+}
+
+static int printsn(struct print_out *po, const char *string, int len,
+		   int width, int flags)
+{
+	int pad	     = (width > len) ? width - len : 0;
+	char padchar = (flags & PAD_ZERO) ? '0' : ' ';
+	int i;
+
+	if (!(flags & PAD_RIGHT)) {
+		for (i = 0; i < pad; i++)
+			printc(po, padchar);
 	}
-	for (; width > 0; --width) {
-		printc(out, out_len, padchar);
-		++pc;
+	printn(po, string, len);
+	if (flags & PAD_RIGHT) {
+		for (i = 0; i < pad; i++)
+			printc(po, padchar);
 	}
 
-	return pc;
+	return len + pad;
 }
 
-static int printi(char **out, u32 *out_len, long long i, int b, int sg,
+static int prints(struct print_out *po, const char *string, int width,
+		  int flags)
+{
+	return printsn(po, string, sbi_strlen(string), width, flags);
+}
+
+static int printi(struct print_out *po, long long i, int b, int sg,
 		  int width, int flags, int letbase)
 {
 	char print_buf[PRINT_BUF_LEN];
-	char *s;
+	char *s, *end;
 	int neg = 0, pc = 0;
-	u64 t;
+	u32 t;
 	unsigned long long u = i;
 
 	if (sg && b == 10 && i < 0) {
@@ -144,17 +319,21 @@ static int printi(char **out, u32 *out_len, long long i, int b, int sg,
 		u   = -i;
 	}
 
-	s  = print_buf + PRINT_BUF_LEN - 1;
-	*s = '\0';
+	s = end = print_buf + PRINT_BUF_LEN;
 
 	if (!u) {
 		*--s = '0';
+	} else if (b == 16) {
+		/* Avoid 64-bit divisions for the common hex case */
+		while (u) {
+			t = u & 0xf;
+			u >>= 4;
+			*--s = (t < 10) ? t + '0' : t - 10 + letbase;
+		}
 	} else {
 		while (u) {
 			t = u % b;
 			u = u / b;
-			if (t >= 10)
-				t += letbase - '0' - 10;
 			*--s = t + '0';
 		}
 	}
@@ -170,7 +349,7 @@ static int printi(char **out, u32 *out_len, long long i, int b, int sg,
 
 	if (neg) {
 		if (width && (flags & PAD_ZERO)) {
-			printc(out, out_len, '-');
+			printc(po, '-');
 			++pc;
 			--width;
 		} else {
@@ -178,14 +357,73 @@ static int printi(char **out, u32 *out_len, long long i, int b, int sg,
 		}
 	}
 
-	return pc + prints(out, out_len, s, width, flags);
+	return pc + printsn(po, s, end - s, width, flags);
 }
 
-static int print(char **out, u32 *out_len, const char *format, va_list args)
+static int print_hartmask(struct print_out *po,
+			  const struct sbi_hartmask *mask)
 {
-	int width, flags;
+	u32 i;
 	int pc = 0;
-	char scr[2];
+
+	if (!mask)
+		return prints(po, "(null)", 0, 0);
+
+	sbi_hartmask_for_each_hart(i, mask) {
+		if (pc) {
+			printc(po, ',');
+			++pc;
+		}
+		pc += printi(po, i, 10, 0, 0, 0, 'a');
+	}
+
+	return pc;
+}
+
+static int print_memregion(struct print_out *po,
+			   const struct sbi_domain_memregion *reg)
+{
+	static const struct {
+		unsigned long flag;
+		char name;
+	} attrs[] = {
+		{ SBI_DOMAIN_MEMREGION_MMODE, 'M' },
+		{ SBI_DOMAIN_MEMREGION_MMIO, 'I' },
+		{ SBI_DOMAIN_MEMREGION_READABLE, 'R' },
+		{ SBI_DOMAIN_MEMREGION_WRITEABLE, 'W' },
+		{ SBI_DOMAIN_MEMREGION_EXECUTABLE, 'X' },
+	};
+	int width = sizeof(unsigned long) * 2;
+	int k = 0, pc = 0;
+	u32 i;
+
+	if (!reg)
+		return prints(po, "(null)", 0, 0);
+
+	pc += printsn(po, "0x", 2, 0, 0);
+	pc += printi(po, reg->base, 16, 0, width, PAD_ZERO, 'a');
+	pc += printsn(po, "-0x", 3, 0, 0);
+	pc += printi(po, sbi_domain_memregion_end(reg), 16, 0, width,
+		     PAD_ZERO, 'a');
+	pc += printsn(po, " (", 2, 0, 0);
+	for (i = 0; i < array_size(attrs); i++) {
+		if (!(reg->flags & attrs[i].flag))
+			continue;
+		if (k++)
+			pc += printsn(po, ",", 1, 0, 0);
+		printc(po, attrs[i].name);
+		++pc;
+	}
+	pc += printsn(po, ")", 1, 0, 0);
+
+	return pc;
+}
+
+static int print(struct print_out *po, const char *format, va_list args)
+{
+	int width, flags, len;
+	int pc = 0;
+	char scr;
 	unsigned long long tmp;
 
 	for (; *format != 0; ++format) {
@@ -216,62 +454,70 @@ static int print(char **out, u32 *out_len, const char *format, va_list args)
 			}
 			if (*format == 's') {
 				char *s = va_arg(args, char *);
-				pc += prints(out, out_len, s ? s : "(null)",
-					     width, flags);
+				pc += prints(po, s ? s : "(null)", width, flags);
 				continue;
 			}
 			if ((*format == 'd') || (*format == 'i')) {
-				pc += printi(out, out_len, va_arg(args, int),
+				pc += printi(po, va_arg(args, int),
 					     10, 1, width, flags, '0');
 				continue;
 			}
 			if (*format == 'x') {
-				pc += printi(out, out_len,
-					     va_arg(args, unsigned int), 16, 0,
-					     width, flags, 'a');
+				pc += printi(po, va_arg(args, unsigned int),
+					     16, 0, width, flags, 'a');
 				continue;
 			}
 			if (*format == 'X') {
-				pc += printi(out, out_len,
-					     va_arg(args, unsigned int), 16, 0,
-					     width, flags, 'A');
+				pc += printi(po, va_arg(args, unsigned int),
+					     16, 0, width, flags, 'A');
 				continue;
 			}
 			if (*format == 'u') {
-				pc += printi(out, out_len,
-					     va_arg(args, unsigned int), 10, 0,
-					     width, flags, 'a');
+				pc += printi(po, va_arg(args, unsigned int),
+					     10, 0, width, flags, 'a');
+				continue;
+			}
+			if (*format == 'p' && *(format + 1) == 'H') {
+				format += 1;
+				pc += print_hartmask(po,
+					va_arg(args, const struct sbi_hartmask *));
+				continue;
+			}
+			if (*format == 'p' && *(format + 1) == 'R') {
+				format += 1;
+				pc += print_memregion(po,
+					va_arg(args,
+					       const struct sbi_domain_memregion *));
 				continue;
 			}
 			if (*format == 'p') {
-				pc += printi(out, out_len,
-					     va_arg(args, unsigned long), 16, 0,
-					     width, flags, 'a');
+				pc += printi(po, va_arg(args, unsigned long),
+					     16, 0, width, flags, 'a');
 				continue;
 			}
 			if (*format == 'P') {
-				pc += printi(out, out_len,
-					     va_arg(args, unsigned long), 16, 0,
-					     width, flags, 'A');
+				pc += printi(po, va_arg(args, unsigned long),
+					     16, 0, width, flags, 'A');
 				continue;
 			}
 			if (*format == 'l' && *(format + 1) == 'l') {
 				tmp = va_arg(args, unsigned long long);
 				if (*(format + 2) == 'u') {
 					format += 2;
-					pc += printi(out, out_len, tmp, 10, 0,
+					pc += printi(po, tmp, 10, 0,
 						     width, flags, 'a');
 				} else if (*(format + 2) == 'x') {
 					format += 2;
-					pc += printi(out, out_len, tmp, 16, 0,
+					pc += printi(po, tmp, 16, 0,
 						     width, flags, 'a');
 				} else if (*(format + 2) == 'X') {
 					format += 2;
-					pc += printi(out, out_len, tmp, 16, 0,
+					pc += printi(po, tmp, 16, 0,
 						     width, flags, 'A');
 				} else {
-					format += 1;
-					pc += printi(out, out_len, tmp, 10, 1,
+					format += (*(format + 2) == 'd' ||
+						   *(format + 2) == 'i') ? 2 : 1;
+					pc += printi(po, tmp, 10, 1,
 						     width, flags, '0');
 				}
 				continue;
@@ -279,38 +525,37 @@ static int print(char **out, u32 *out_len, const char *format, va_list args)
 				if (*(format + 1) == 'u') {
 					format += 1;
 					pc += printi(
-						out, out_len,
-						va_arg(args, unsigned long), 10,
-						0, width, flags, 'a');
+						po, va_arg(args, unsigned long),
+						10, 0, width, flags, 'a');
 				} else if (*(format + 1) == 'x') {
 					format += 1;
 					pc += printi(
-						out, out_len,
-						va_arg(args, unsigned long), 16,
-						0, width, flags, 'a');
+						po, va_arg(args, unsigned long),
+						16, 0, width, flags, 'a');
 				} else if (*(format + 1) == 'X') {
 					format += 1;
 					pc += printi(
-						out, out_len,
-						va_arg(args, unsigned long), 16,
-						0, width, flags, 'A');
+						po, va_arg(args, unsigned long),
+						16, 0, width, flags, 'A');
 				} else {
-					pc += printi(out, out_len,
-						     va_arg(args, long), 10, 1,
-						     width, flags, '0');
+					pc += printi(po, va_arg(args, long),
+						     10, 1, width, flags, '0');
 				}
 			}
 			if (*format == 'c') {
 				/* char are converted to int then pushed on the stack */
-				scr[0] = va_arg(args, int);
-				scr[1] = '\0';
-				pc += prints(out, out_len, scr, width, flags);
+				scr = va_arg(args, int);
+				pc += printsn(po, &scr, 1, width, flags);
 				continue;
 			}
 		} else {
 literal:
-			printc(out, out_len, *format);
-			++pc;
+			/* Copy the whole run of literal characters at once */
+			for (len = 1; format[len] && format[len] != '%'; len++)
+				;
+			printn(po, format, len);
+			pc += len;
+			format += len - 1;
 		}
 	}
 
@@ -321,13 +566,15 @@ int sbi_sprintf(char *out, const char *format, ...)
 {
 	va_list args;
 	int retval;
+	struct print_out po = { .buf = out, .size = -1U };
 
 	if (unlikely(!out))
 		sbi_panic("sbi_sprintf called with NULL output string\n");
 
 	va_start(args, format);
-	retval = print(&out, NULL, format, args);
+	retval = print(&po, format, args);
 	va_end(args);
+	out[po.pos] = '\0';
 
 	return retval;
 }
@@ -336,14 +583,17 @@ int sbi_snprintf(char *out, u32 out_sz, const char *format, ...)
 {
 	va_list args;
 	int retval;
+	struct print_out po = { .buf = out, .size = out_sz ? out_sz - 1 : 0 };
 
 	if (unlikely(!out && out_sz != 0))
 		sbi_panic("sbi_snprintf called with NULL output string and "
 			  "output size is not zero\n");
 
 	va_start(args, format);
-	retval = print(&out, &out_sz, format, args);
+	retval = print(&po, format, args);
 	va_end(args);
+	if (out_sz)
+		out[po.pos] = '\0';
 
 	return retval;
 }
@@ -352,12 +602,16 @@ int sbi_printf(const char *format, ...)
 {
 	va_list args;
 	int retval;
+	char buf[PRINT_CONSOLE_BUF_LEN];
+	struct print_out po = { .buf = buf, .size = sizeof(buf),
+				.console = TRUE };
 
-	spin_lock(&console_out_lock);
+	qspin_lock(&console_out_lock);
 	va_start(args, format);
-	retval = print(NULL, NULL, format, args);
+	retval = print(&po, format, args);
 	va_end(args);
-	spin_unlock(&console_out_lock);
+	print_flush(&po);
+	console_out_unlock();
 
 	return retval;
 }
@@ -367,12 +621,16 @@ int sbi_dprintf(const char *format, ...)
 	va_list args;
 	int retval = 0;
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	char buf[PRINT_CONSOLE_BUF_LEN];
+	struct print_out po = { .buf = buf, .size = sizeof(buf),
+				.console = TRUE };
 
 	va_start(args, format);
 	if (scratch->options & SBI_SCRATCH_DEBUG_PRINTS) {
-		spin_lock(&console_out_lock);
-		retval = print(NULL, NULL, format, args);
-		spin_unlock(&console_out_lock);
+		qspin_lock(&console_out_lock);
+		retval = print(&po, format, args);
+		print_flush(&po);
+		console_out_unlock();
 	}
 	va_end(args);
 
@@ -382,13 +640,18 @@ int sbi_dprintf(const char *format, ...)
 void sbi_panic(const char *format, ...)
 {
 	va_list args;
+	char buf[PRINT_CONSOLE_BUF_LEN];
+	struct print_out po = { .buf = buf, .size = sizeof(buf),
+				.console = TRUE };
 
-	spin_lock(&console_out_lock);
+	qspin_lock(&console_out_lock);
 	va_start(args, format);
-	print(NULL, NULL, format, args);
+	print(&po, format, args);
 	va_end(args);
-	spin_unlock(&console_out_lock);
+	print_flush(&po);
+	console_out_unlock();
 
+	sbi_console_flush();
 	sbi_hart_hang();
 }
 
@@ -22,6 +22,20 @@ struct sbi_domain *domidx_to_domain_table[SBI_DOMAIN_MAX_INDEX] = { 0 };
 static u32 domain_count = 0;
 static bool domain_finalized = false;
 
+/** Per-HART cache of the last memory region lookup table hit */
+struct domain_lookup_hit {
+	const struct sbi_domain *dom;
+	const struct sbi_domain_memregion_lookup *ent;
+};
+
+static unsigned long domain_lookup_hit_off;
+
+/** Memory region lookup table entries shared by all domains */
+#define DOMAIN_LOOKUP_ENTRIES	CONFIG_SBI_DOMAIN_MEMREGION_LOOKUP_ENTRIES
+static struct sbi_domain_memregion_lookup
+				domain_lookup_pool[DOMAIN_LOOKUP_ENTRIES];
+static u32 domain_lookup_pool_used;
+
 static struct sbi_hartmask root_hmask = { 0 };
 
 #define ROOT_REGION_MAX	16
@@ -34,6 +48,7 @@ struct sbi_domain root = {
 	.possible_harts = &root_hmask,
 	.regions = root_memregs,
 	.system_reset_allowed = TRUE,
+	.system_suspend_allowed = TRUE,
 };
 
 bool sbi_domain_is_assigned_hart(const struct sbi_domain *dom, u32 hartid)
@@ -101,13 +116,60 @@ void sbi_domain_memregion_init(unsigned long addr,
 	}
 }
 
+static bool domain_memregion_allowed(const struct sbi_domain_memregion *reg,
+				     unsigned long mode, unsigned long rwx,
+				     bool mmio)
+{
+	bool rmmio;
+
+	if (!reg)
+		return (mode == PRV_M) ? TRUE : FALSE;
+
+	rmmio = (reg->flags & SBI_DOMAIN_MEMREGION_MMIO) ? TRUE : FALSE;
+	if (mmio != rmmio)
+		return FALSE;
+
+	return ((reg->flags & rwx) == rwx) ? TRUE : FALSE;
+}
+
+static const struct sbi_domain_memregion_lookup *domain_lookup_find(
+					const struct sbi_domain *dom,
+					unsigned long addr)
+{
+	u32 lo, hi, mid;
+	struct domain_lookup_hit *hit =
+			sbi_scratch_thishart_offset_ptr(domain_lookup_hit_off);
+
+	/* Check the last hit of current HART first */
+	if (hit->dom == dom &&
+	    hit->ent->start <= addr && addr <= hit->ent->end)
+		return hit->ent;
+
+	/* Binary search for the entry containing the address */
+	lo = 0;
+	hi = dom->lookup_count - 1;
+	while (lo < hi) {
+		mid = lo + (hi - lo + 1) / 2;
+		if (dom->lookup[mid].start <= addr)
+			lo = mid;
+		else
+			hi = mid - 1;
+	}
+
+	hit->dom = dom;
+	hit->ent = &dom->lookup[lo];
+
+	return hit->ent;
+}
+
 bool sbi_domain_check_addr(const struct sbi_domain *dom,
 			   unsigned long addr, unsigned long mode,
 			   unsigned long access_flags)
 {
-	bool rmmio, mmio = FALSE;
+	bool mmio = FALSE;
 	struct sbi_domain_memregion *reg;
-	unsigned long rstart, rend, rflags, rwx = 0;
+	const struct sbi_domain_memregion_lookup *ent;
+	unsigned long rwx = 0;
 
 	if (!dom)
 		return FALSE;
@@ -121,23 +183,71 @@ bool sbi_domain_check_addr(const struct sbi_domain *dom,
 	if (access_flags & SBI_DOMAIN_MMIO)
 		mmio = TRUE;
 
+	if (dom->lookup_count) {
+		ent = domain_lookup_find(dom, addr);
+		return domain_memregion_allowed((mode == PRV_M) ?
+						ent->mreg : ent->sreg,
+						mode, rwx, mmio);
+	}
+
 	sbi_domain_for_each_memregion(dom, reg) {
-		rflags = reg->flags;
-		if (mode == PRV_M && !(rflags & SBI_DOMAIN_MEMREGION_MMODE))
+		if (mode == PRV_M &&
+		    !(reg->flags & SBI_DOMAIN_MEMREGION_MMODE))
 			continue;
 
-		rstart = reg->base;
-		rend = (reg->order < __riscv_xlen) ?
-			rstart + ((1UL << reg->order) - 1) : -1UL;
-		if (rstart <= addr && addr <= rend) {
-			rmmio = (rflags & SBI_DOMAIN_MEMREGION_MMIO) ? TRUE : FALSE;
-			if (mmio != rmmio)
-				return FALSE;
-			return ((rflags & rwx) == rwx) ? TRUE : FALSE;
-		}
+		if (reg->base <= addr && addr <= sbi_domain_memregion_end(reg))
+			return domain_memregion_allowed(reg, mode, rwx, mmio);
 	}
 
-	return (mode == PRV_M) ? TRUE : FALSE;
+	return domain_memregion_allowed(NULL, mode, rwx, mmio);
+}
+
+/*
+ * Find the last address of the range starting at given address over
+ * which the memory regions of a domain do not change.
+ */
+static unsigned long domain_addr_range_end(const struct sbi_domain *dom,
+					   unsigned long addr)
+{
+	unsigned long rend, end = -1UL;
+	struct sbi_domain_memregion *reg;
+
+	if (dom->lookup_count)
+		return domain_lookup_find(dom, addr)->end;
+
+	sbi_domain_for_each_memregion(dom, reg) {
+		rend = sbi_domain_memregion_end(reg);
+		if (addr < reg->base && reg->base - 1 < end)
+			end = reg->base - 1;
+		else if (reg->base <= addr && addr <= rend && rend < end)
+			end = rend;
+	}
+
+	return end;
+}
+
+bool sbi_domain_check_addr_range(const struct sbi_domain *dom,
+				 unsigned long addr, unsigned long size,
+				 unsigned long mode,
+				 unsigned long access_flags)
+{
+	unsigned long end, last;
+
+	if (!dom || !size || addr + size - 1 < addr)
+		return FALSE;
+
+	last = addr + size - 1;
+	while (1) {
+		if (!sbi_domain_check_addr(dom, addr, mode, access_flags))
+			return FALSE;
+
+		end = domain_addr_range_end(dom, addr);
+		if (last <= end)
+			break;
+		addr = end + 1;
+	}
+
+	return TRUE;
 }
 
 /* Check if region complies with constraints */
@@ -308,8 +418,8 @@ static int sanitize_domain(const struct sbi_platform *plat,
 
 void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix)
 {
-	u32 i, k;
-	unsigned long rstart, rend;
+	u32 i;
+	struct sbi_hartmask assigned;
 	struct sbi_domain_memregion *reg;
 
 	sbi_printf("Domain%d Name        %s: %s\n",
@@ -318,35 +428,20 @@ void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix)
 	sbi_printf("Domain%d Boot HART   %s: %d\n",
 		   dom->index, suffix, dom->boot_hartid);
 
-	k = 0;
-	sbi_printf("Domain%d HARTs       %s: ", dom->index, suffix);
-	sbi_hartmask_for_each_hart(i, dom->possible_harts)
-		sbi_printf("%s%d%s", (k++) ? "," : "",
-			   i, sbi_domain_is_assigned_hart(dom, i) ? "*" : "");
-	sbi_printf("\n");
+	sbi_hartmask_clear_all(&assigned);
+	sbi_hartmask_for_each_hart(i, dom->possible_harts) {
+		if (sbi_domain_is_assigned_hart(dom, i))
+			sbi_hartmask_set_hart(i, &assigned);
+	}
+	sbi_printf("Domain%d HARTs       %s: %pH\n",
+		   dom->index, suffix, dom->possible_harts);
+	sbi_printf("Domain%d Assigned    %s: %pH\n",
+		   dom->index, suffix, &assigned);
 
 	i = 0;
 	sbi_domain_for_each_memregion(dom, reg) {
-		rstart = reg->base;
-		rend = (reg->order < __riscv_xlen) ?
-			rstart + ((1UL << reg->order) - 1) : -1UL;
-
-		sbi_printf("Domain%d Region%02d    %s: 0x%" PRILX "-0x%" PRILX " ",
-			   dom->index, i, suffix, rstart, rend);
-
-		k = 0;
-		if (reg->flags & SBI_DOMAIN_MEMREGION_MMODE)
-			sbi_printf("%cM", (k++) ? ',' : '(');
-		if (reg->flags & SBI_DOMAIN_MEMREGION_MMIO)
-			sbi_printf("%cI", (k++) ? ',' : '(');
-		if (reg->flags & SBI_DOMAIN_MEMREGION_READABLE)
-			sbi_printf("%cR", (k++) ? ',' : '(');
-		if (reg->flags & SBI_DOMAIN_MEMREGION_WRITEABLE)
-			sbi_printf("%cW", (k++) ? ',' : '(');
-		if (reg->flags & SBI_DOMAIN_MEMREGION_EXECUTABLE)
-			sbi_printf("%cX", (k++) ? ',' : '(');
-		sbi_printf("%s\n", (k++) ? ")" : "()");
-
+		sbi_printf("Domain%d Region%02d    %s: %pR\n",
+			   dom->index, i, suffix, reg);
 		i++;
 	}
 
@@ -374,6 +469,9 @@ void sbi_domain_dump(const struct sbi_domain *dom, const char *suffix)
 
 	sbi_printf("Domain%d SysReset    %s: %s\n",
 		   dom->index, suffix, (dom->system_reset_allowed) ? "yes" : "no");
+
+	sbi_printf("Domain%d SysSuspend  %s: %s\n",
+		   dom->index, suffix, (dom->system_suspend_allowed) ? "yes" : "no");
 }
 
 void sbi_domain_dump_all(const char *suffix)
@@ -552,6 +650,99 @@ int sbi_domain_root_add_memrange(unsigned long addr, unsigned long size,
 	return 0;
 }
 
+static void domain_build_lookup(struct sbi_domain *dom)
+{
+	u32 i, j, k, count = 0, nbounds = 0;
+	unsigned long t, start, end;
+	const struct sbi_domain_memregion *reg, *mreg, *sreg;
+	struct sbi_domain_memregion_lookup *bounds, *ent;
+
+	dom->lookup = NULL;
+	dom->lookup_count = 0;
+
+	/*
+	 * Each memory region adds at most two boundaries to the address
+	 * space so fallback to walking the memory regions if there are
+	 * not enough free entries in the lookup table pool.
+	 */
+	sbi_domain_for_each_memregion(dom, reg)
+		count++;
+	if ((DOMAIN_LOOKUP_ENTRIES - domain_lookup_pool_used) <
+	    (2 * count + 1))
+		return;
+	bounds = &domain_lookup_pool[domain_lookup_pool_used];
+
+	/*
+	 * Collect the sorted and unique boundaries of memory regions
+	 * in the start address of free lookup table entries.
+	 */
+	bounds[nbounds++].start = 0;
+	sbi_domain_for_each_memregion(dom, reg) {
+		for (i = 0; i < 2; i++) {
+			if (!i)
+				t = reg->base;
+			else if (sbi_domain_memregion_end(reg) != -1UL)
+				t = sbi_domain_memregion_end(reg) + 1;
+			else
+				break;
+
+			for (j = 0; j < nbounds && bounds[j].start < t; j++)
+				;
+			if (j < nbounds && bounds[j].start == t)
+				continue;
+			for (k = nbounds; k > j; k--)
+				bounds[k].start = bounds[k - 1].start;
+			bounds[j].start = t;
+			nbounds++;
+		}
+	}
+
+	/*
+	 * Memory regions never partially overlap an address range between
+	 * two boundaries so the first matching memory region (in sorted
+	 * order) for the start of a range applies to the whole range.
+	 *
+	 * The lookup table is built in place over the boundaries. This
+	 * is safe because entry N is written only after boundaries N and
+	 * N + 1 have been consumed.
+	 */
+	dom->lookup = bounds;
+	for (i = 0; i < nbounds; i++) {
+		start = bounds[i].start;
+		end = (i + 1 < nbounds) ? bounds[i + 1].start - 1 : -1UL;
+
+		mreg = sreg = NULL;
+		sbi_domain_for_each_memregion(dom, reg) {
+			if (start < reg->base ||
+			    sbi_domain_memregion_end(reg) < start)
+				continue;
+			if (!sreg)
+				sreg = reg;
+			if (!mreg && (reg->flags & SBI_DOMAIN_MEMREGION_MMODE))
+				mreg = reg;
+			if (mreg && sreg)
+				break;
+		}
+
+		/* Merge with previous entry if the same regions match */
+		ent = &dom->lookup[dom->lookup_count];
+		if (dom->lookup_count &&
+		    (ent - 1)->mreg == mreg && (ent - 1)->sreg == sreg) {
+			(ent - 1)->end = end;
+			continue;
+		}
+
+		ent->start = start;
+		ent->end = end;
+		ent->mreg = mreg;
+		ent->sreg = sreg;
+		dom->lookup_count++;
+	}
+
+	/* Return the entries saved by merging to the pool */
+	domain_lookup_pool_used += dom->lookup_count;
+}
+
 int sbi_domain_finalize(struct sbi_scratch *scratch, u32 cold_hartid)
 {
 	int rc;
@@ -567,6 +758,10 @@ int sbi_domain_finalize(struct sbi_scratch *scratch, u32 cold_hartid)
 		return rc;
 	}
 
+	/* Build memory region lookup table of domains */
+	sbi_domain_for_each(i, dom)
+		domain_build_lookup(dom);
+
 	/* Startup boot HART of domains */
 	sbi_domain_for_each(i, dom) {
 		/* Domain boot HART */
@@ -618,6 +813,11 @@ int sbi_domain_init(struct sbi_scratch *scratch, u32 cold_hartid)
 	u32 i;
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 
+	domain_lookup_hit_off =
+		sbi_scratch_alloc_offset(sizeof(struct domain_lookup_hit));
+	if (!domain_lookup_hit_off)
+		return SBI_ENOMEM;
+
 	/* Root domain firmware memory region */
 	sbi_domain_memregion_init(scratch->fw_start, scratch->fw_size, 0,
 				  &root_fw_region);
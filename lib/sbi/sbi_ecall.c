@@ -12,6 +12,7 @@
 #include <sbi/sbi_ecall_interface.h>
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_trap.h>
+#include <sbi/sbi_trap_stats.h>
 
 extern struct sbi_ecall_extension *sbi_ecall_exts[];
 extern unsigned long sbi_ecall_exts_size;
@@ -38,61 +39,157 @@ void sbi_ecall_set_impid(unsigned long impid)
 	ecall_impid = impid;
 }
 
-static SBI_LIST_HEAD(ecall_exts_list);
+/* Registered extensions, the slot of an extension never changes */
+static struct sbi_ecall_extension *ecall_exts_slot[SBI_ECALL_MAX_EXTENSIONS];
 
-struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid)
+/* Slots of registered extensions sorted by extid_start */
+static int ecall_exts_sorted[SBI_ECALL_MAX_EXTENSIONS];
+static u32 ecall_exts_count;
+
+/* Direct slots for the extensions used by S-mode on hot paths */
+enum sbi_ecall_hot_ext {
+	SBI_ECALL_HOT_TIME = 0,
+	SBI_ECALL_HOT_IPI,
+	SBI_ECALL_HOT_RFENCE,
+	SBI_ECALL_HOT_LEGACY,
+	SBI_ECALL_HOT_MAX,
+};
+
+static int ecall_exts_hot[SBI_ECALL_HOT_MAX] = {
+	[0 ... SBI_ECALL_HOT_MAX - 1] = -1,
+};
+
+static int ecall_search_slot(unsigned long extid)
 {
-	struct sbi_ecall_extension *t, *ret = NULL;
+	int slot;
+	u32 lo = 0, hi = ecall_exts_count, mid;
 
-	sbi_list_for_each_entry(t, &ecall_exts_list, head) {
-		if (t->extid_start <= extid && extid <= t->extid_end) {
-			ret = t;
-			break;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		slot = ecall_exts_sorted[mid];
+		if (extid < ecall_exts_slot[slot]->extid_start)
+			hi = mid;
+		else if (ecall_exts_slot[slot]->extid_end < extid)
+			lo = mid + 1;
+		else
+			return slot;
+	}
+
+	return -1;
+}
+
+static int ecall_find_slot(unsigned long extid)
+{
+	int slot;
+
+	switch (extid) {
+	case SBI_EXT_TIME:
+		slot = ecall_exts_hot[SBI_ECALL_HOT_TIME];
+		break;
+	case SBI_EXT_IPI:
+		slot = ecall_exts_hot[SBI_ECALL_HOT_IPI];
+		break;
+	case SBI_EXT_RFENCE:
+		slot = ecall_exts_hot[SBI_ECALL_HOT_RFENCE];
+		break;
+	case SBI_EXT_0_1_SET_TIMER ... SBI_EXT_0_1_SHUTDOWN:
+		slot = ecall_exts_hot[SBI_ECALL_HOT_LEGACY];
+		break;
+	default:
+		slot = -1;
+		break;
+	}
+
+	return (slot < 0) ? ecall_search_slot(extid) : slot;
+}
+
+static void ecall_exts_rebuild(void)
+{
+	int slot, legacy;
+	u32 i, j, count = 0;
+
+	/* Insertion sort of registered slots by extid_start */
+	for (i = 0; i < SBI_ECALL_MAX_EXTENSIONS; i++) {
+		if (!ecall_exts_slot[i])
+			continue;
+		for (j = count; j > 0; j--) {
+			slot = ecall_exts_sorted[j - 1];
+			if (ecall_exts_slot[slot]->extid_start <
+			    ecall_exts_slot[i]->extid_start)
+				break;
+			ecall_exts_sorted[j] = slot;
 		}
+		ecall_exts_sorted[j] = i;
+		count++;
 	}
+	ecall_exts_count = count;
+
+	ecall_exts_hot[SBI_ECALL_HOT_TIME] = ecall_search_slot(SBI_EXT_TIME);
+	ecall_exts_hot[SBI_ECALL_HOT_IPI] = ecall_search_slot(SBI_EXT_IPI);
+	ecall_exts_hot[SBI_ECALL_HOT_RFENCE] =
+				ecall_search_slot(SBI_EXT_RFENCE);
+
+	/* The legacy slot is only direct if it covers all legacy IDs */
+	legacy = ecall_search_slot(SBI_EXT_0_1_SET_TIMER);
+	if (legacy >= 0 &&
+	    ecall_exts_slot[legacy]->extid_end < SBI_EXT_0_1_SHUTDOWN)
+		legacy = -1;
+	ecall_exts_hot[SBI_ECALL_HOT_LEGACY] = legacy;
+}
 
-	return ret;
+struct sbi_ecall_extension *sbi_ecall_find_extension(unsigned long extid)
+{
+	int slot = ecall_find_slot(extid);
+
+	return (slot < 0) ? NULL : ecall_exts_slot[slot];
 }
 
 int sbi_ecall_register_extension(struct sbi_ecall_extension *ext)
 {
+	u32 i;
+	int slot = -1;
 	struct sbi_ecall_extension *t;
 
 	if (!ext || (ext->extid_end < ext->extid_start) || !ext->handle)
 		return SBI_EINVAL;
 
-	sbi_list_for_each_entry(t, &ecall_exts_list, head) {
-		unsigned long start = t->extid_start;
-		unsigned long end = t->extid_end;
-		if (end < ext->extid_start || ext->extid_end < start)
+	for (i = 0; i < SBI_ECALL_MAX_EXTENSIONS; i++) {
+		t = ecall_exts_slot[i];
+		if (!t) {
+			if (slot < 0)
+				slot = i;
+			continue;
+		}
+		if (t->extid_end < ext->extid_start ||
+		    ext->extid_end < t->extid_start)
 			/* no overlap */;
 		else
 			return SBI_EINVAL;
 	}
 
-	SBI_INIT_LIST_HEAD(&ext->head);
-	sbi_list_add_tail(&ext->head, &ecall_exts_list);
+	if (slot < 0)
+		return SBI_ENOSPC;
+
+	ecall_exts_slot[slot] = ext;
+	ecall_exts_rebuild();
 
 	return 0;
 }
 
 void sbi_ecall_unregister_extension(struct sbi_ecall_extension *ext)
 {
-	bool found = FALSE;
-	struct sbi_ecall_extension *t;
+	u32 i;
 
 	if (!ext)
 		return;
 
-	sbi_list_for_each_entry(t, &ecall_exts_list, head) {
-		if (t == ext) {
-			found = TRUE;
+	for (i = 0; i < SBI_ECALL_MAX_EXTENSIONS; i++) {
+		if (ecall_exts_slot[i] == ext) {
+			ecall_exts_slot[i] = NULL;
+			ecall_exts_rebuild();
 			break;
 		}
 	}
-
-	if (found)
-		sbi_list_del_init(&ext->head);
 }
 
 int sbi_ecall_handler(struct sbi_trap_regs *regs)
@@ -104,11 +201,16 @@ int sbi_ecall_handler(struct sbi_trap_regs *regs)
 	struct sbi_trap_info trap = {0};
 	unsigned long out_val = 0;
 	bool is_0_1_spec = 0;
+	ulong stats_start;
+	int slot;
 
-	ext = sbi_ecall_find_extension(extension_id);
+	slot = ecall_find_slot(extension_id);
+	ext = (slot < 0) ? NULL : ecall_exts_slot[slot];
 	if (ext && ext->handle) {
+		stats_start = sbi_trap_stats_start();
 		ret = ext->handle(extension_id, func_id,
 				  regs, &out_val, &trap);
+		sbi_trap_stats_record_ecall(slot, ext, func_id, stats_start);
 		if (extension_id >= SBI_EXT_0_1_SET_TIMER &&
 		    extension_id <= SBI_EXT_0_1_SHUTDOWN)
 			is_0_1_spec = 1;
@@ -0,0 +1,344 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_bitops.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_hfence.h>
+#include <sbi/sbi_nacl.h>
+#include <sbi/sbi_platform.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_trap.h>
+
+/* Scratch offset of the per-HART NACL shared memory pointer */
+static unsigned long nacl_shmem_offset;
+
+static inline void **nacl_thishart_shmem_ptr(void)
+{
+	if (!nacl_shmem_offset)
+		return NULL;
+
+	return sbi_scratch_thishart_offset_ptr(nacl_shmem_offset);
+}
+
+static inline void *nacl_thishart_shmem(void)
+{
+	void **shmem_ptr = nacl_thishart_shmem_ptr();
+
+	return (shmem_ptr) ? *shmem_ptr : NULL;
+}
+
+static inline unsigned long *nacl_shmem_csrs(void *shmem)
+{
+	return shmem + SBI_NACL_SHMEM_CSR_OFFSET;
+}
+
+static inline unsigned long *nacl_shmem_dbitmap(void *shmem)
+{
+	return shmem + SBI_NACL_SHMEM_DBITMAP_OFFSET;
+}
+
+static inline unsigned long *nacl_shmem_hfence(void *shmem, unsigned int i)
+{
+	return shmem + SBI_NACL_SHMEM_HFENCE_OFFSET +
+	       i * SBI_NACL_HFENCE_ENTRY_WORDS * sizeof(unsigned long);
+}
+
+/*
+ * H-extension CSRs which can be synchronized through the shared
+ * memory. Read-only CSRs (such as HIP and HGEIP) are not included.
+ */
+#if __riscv_xlen == 32
+#define nacl_for_each_csr_rv32(__f)		\
+	__f(CSR_HTIMEDELTAH)
+#else
+#define nacl_for_each_csr_rv32(__f)
+#endif
+
+#define nacl_for_each_csr(__f)			\
+	__f(CSR_HSTATUS)			\
+	__f(CSR_HEDELEG)			\
+	__f(CSR_HIDELEG)			\
+	__f(CSR_HIE)				\
+	__f(CSR_HCOUNTEREN)			\
+	__f(CSR_HGEIE)				\
+	__f(CSR_HTVAL)				\
+	__f(CSR_HVIP)				\
+	__f(CSR_HTINST)				\
+	__f(CSR_HGATP)				\
+	__f(CSR_HTIMEDELTA)			\
+	__f(CSR_VSSTATUS)			\
+	__f(CSR_VSIE)				\
+	__f(CSR_VSTVEC)				\
+	__f(CSR_VSSCRATCH)			\
+	__f(CSR_VSEPC)				\
+	__f(CSR_VSCAUSE)			\
+	__f(CSR_VSTVAL)				\
+	__f(CSR_VSIP)				\
+	__f(CSR_VSATP)				\
+	nacl_for_each_csr_rv32(__f)
+
+static const unsigned long nacl_csrs[] = {
+#define nacl_csr_entry(__csr)	__csr,
+	nacl_for_each_csr(nacl_csr_entry)
+#undef nacl_csr_entry
+};
+
+static int nacl_csr_sync_one(void *shmem, unsigned long csr_num)
+{
+	unsigned long *csrs = nacl_shmem_csrs(shmem);
+	unsigned long *dbitmap = nacl_shmem_dbitmap(shmem);
+	unsigned long idx = SBI_NACL_SHMEM_CSR_INDEX(csr_num);
+	bool dirty = __test_and_clear_bit(idx, dbitmap);
+
+	/*
+	 * Write the dirty value and read back the CSR so that the
+	 * hypervisor always sees the legalized (WARL) value.
+	 */
+	switch (csr_num) {
+#define nacl_csr_case(__csr)					\
+	case __csr:						\
+		if (dirty)					\
+			csr_write(__csr, csrs[idx]);		\
+		csrs[idx] = csr_read(__csr);			\
+		break;
+	nacl_for_each_csr(nacl_csr_case)
+#undef nacl_csr_case
+	default:
+		return SBI_EINVAL;
+	}
+
+	return 0;
+}
+
+static int nacl_sync_csr(unsigned long csr_num)
+{
+	unsigned int i;
+	void *shmem = nacl_thishart_shmem();
+
+	if (!shmem)
+		return SBI_ENO_SHMEM;
+
+	if (csr_num != -1UL)
+		return nacl_csr_sync_one(shmem, csr_num);
+
+	for (i = 0; i < array_size(nacl_csrs); i++)
+		nacl_csr_sync_one(shmem, nacl_csrs[i]);
+
+	return 0;
+}
+
+static int nacl_hfence_one(unsigned long *entry, unsigned long limit)
+{
+	unsigned long i, hgatp = 0, page_size, start, count;
+	unsigned long config = entry[0];
+	unsigned long type, order, vmid, asid;
+	int rc = 0;
+
+	if (!(config & SBI_NACL_HFENCE_CONFIG_PEND))
+		return 0;
+
+	type = (config >> SBI_NACL_HFENCE_CONFIG_TYPE_SHIFT) &
+		SBI_NACL_HFENCE_CONFIG_TYPE_MASK;
+	order = ((config >> SBI_NACL_HFENCE_CONFIG_ORDER_SHIFT) &
+		 SBI_NACL_HFENCE_CONFIG_ORDER_MASK) + 12;
+	vmid = (config >> SBI_NACL_HFENCE_CONFIG_VMID_SHIFT) &
+		SBI_NACL_HFENCE_CONFIG_VMID_MASK;
+	asid = config & SBI_NACL_HFENCE_CONFIG_ASID_MASK;
+	count = entry[3];
+
+	if (order >= __riscv_xlen) {
+		rc = SBI_EINVAL;
+		goto done;
+	}
+	page_size = 1UL << order;
+	start = entry[1] << order;
+
+	/* Ranges above the platform limit are upgraded to full flushes */
+	if (count > limit / page_size) {
+		switch (type) {
+		case SBI_NACL_HFENCE_TYPE_GVMA:
+		case SBI_NACL_HFENCE_TYPE_GVMA_VMID:
+		case SBI_NACL_HFENCE_TYPE_VVMA:
+		case SBI_NACL_HFENCE_TYPE_VVMA_ASID:
+			type++;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if (type >= SBI_NACL_HFENCE_TYPE_VVMA)
+		hgatp = csr_swap(CSR_HGATP,
+				 (vmid << HGATP_VMID_SHIFT) & HGATP_VMID_MASK);
+
+	switch (type) {
+	case SBI_NACL_HFENCE_TYPE_GVMA:
+		for (i = 0; i < count; i++)
+			__sbi_hfence_gvma_gpa((start + i * page_size) >> 2);
+		break;
+	case SBI_NACL_HFENCE_TYPE_GVMA_ALL:
+		__sbi_hfence_gvma_all();
+		break;
+	case SBI_NACL_HFENCE_TYPE_GVMA_VMID:
+		for (i = 0; i < count; i++)
+			__sbi_hfence_gvma_vmid_gpa((start + i * page_size) >> 2,
+						   vmid);
+		break;
+	case SBI_NACL_HFENCE_TYPE_GVMA_VMID_ALL:
+		__sbi_hfence_gvma_vmid(vmid);
+		break;
+	case SBI_NACL_HFENCE_TYPE_VVMA:
+		for (i = 0; i < count; i++)
+			__sbi_hfence_vvma_va(start + i * page_size);
+		break;
+	case SBI_NACL_HFENCE_TYPE_VVMA_ALL:
+		__sbi_hfence_vvma_all();
+		break;
+	case SBI_NACL_HFENCE_TYPE_VVMA_ASID:
+		for (i = 0; i < count; i++)
+			__sbi_hfence_vvma_asid_va(start + i * page_size, asid);
+		break;
+	case SBI_NACL_HFENCE_TYPE_VVMA_ASID_ALL:
+		__sbi_hfence_vvma_asid(asid);
+		break;
+	default:
+		rc = SBI_EINVAL;
+		break;
+	}
+
+	if (type >= SBI_NACL_HFENCE_TYPE_VVMA)
+		csr_write(CSR_HGATP, hgatp);
+
+done:
+	entry[0] = config & ~SBI_NACL_HFENCE_CONFIG_PEND;
+	return rc;
+}
+
+static int nacl_sync_hfence(unsigned long entry_index)
+{
+	int rc, ret = 0;
+	unsigned int i;
+	unsigned long limit;
+	void *shmem = nacl_thishart_shmem();
+
+	if (!shmem)
+		return SBI_ENO_SHMEM;
+
+	limit = sbi_platform_tlbr_flush_limit(sbi_platform_thishart_ptr());
+
+	if (entry_index != -1UL) {
+		if (entry_index >= SBI_NACL_HFENCE_ENTRY_COUNT)
+			return SBI_EINVAL;
+		return nacl_hfence_one(nacl_shmem_hfence(shmem, entry_index),
+				       limit);
+	}
+
+	for (i = 0; i < SBI_NACL_HFENCE_ENTRY_COUNT; i++) {
+		rc = nacl_hfence_one(nacl_shmem_hfence(shmem, i), limit);
+		if (rc)
+			ret = rc;
+	}
+
+	return ret;
+}
+
+static int nacl_set_shmem(unsigned long shmem_lo, unsigned long shmem_hi,
+			  unsigned long flags)
+{
+	void **shmem_ptr = nacl_thishart_shmem_ptr();
+
+	if (!shmem_ptr)
+		return SBI_ENOTSUPP;
+
+	if (flags)
+		return SBI_EINVAL;
+
+	/* All-ones address disables the NACL shared memory */
+	if (shmem_lo == -1UL && shmem_hi == -1UL) {
+		*shmem_ptr = NULL;
+		return 0;
+	}
+
+	if (shmem_lo & (SBI_NACL_SHMEM_SCRATCH_SIZE - 1))
+		return SBI_EINVAL;
+
+	/* Only shared memory addressable by M-mode is supported */
+	if (shmem_hi ||
+	    !sbi_domain_check_addr_range(sbi_domain_thishart_ptr(), shmem_lo,
+					 SBI_NACL_SHMEM_SIZE, PRV_S,
+					 SBI_DOMAIN_READ | SBI_DOMAIN_WRITE))
+		return SBI_EINVALID_ADDR;
+
+	*shmem_ptr = (void *)shmem_lo;
+
+	return 0;
+}
+
+static int sbi_ecall_nacl_handler(unsigned long extid, unsigned long funcid,
+				  const struct sbi_trap_regs *regs,
+				  unsigned long *out_val,
+				  struct sbi_trap_info *out_trap)
+{
+	int ret = 0;
+
+	if (!misa_extension('H'))
+		return SBI_ENOTSUPP;
+
+	switch (funcid) {
+	case SBI_EXT_NACL_PROBE_FEATURE:
+		switch (regs->a0) {
+		case SBI_NACL_FEAT_SYNC_CSR:
+		case SBI_NACL_FEAT_SYNC_HFENCE:
+			*out_val = 1;
+			break;
+		default:
+			*out_val = 0;
+			break;
+		}
+		break;
+	case SBI_EXT_NACL_SET_SHMEM:
+		ret = nacl_set_shmem(regs->a0, regs->a1, regs->a2);
+		break;
+	case SBI_EXT_NACL_SYNC_CSR:
+		ret = nacl_sync_csr(regs->a0);
+		break;
+	case SBI_EXT_NACL_SYNC_HFENCE:
+		ret = nacl_sync_hfence(regs->a0);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+		break;
+	}
+
+	return ret;
+}
+
+static int sbi_ecall_nacl_probe(unsigned long extid, unsigned long *out_val)
+{
+	/* Only available to hypervisors running on HARTs with H-extension */
+	*out_val = misa_extension('H') ? 1 : 0;
+	return 0;
+}
+
+int sbi_nacl_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	if (cold_boot)
+		nacl_shmem_offset = sbi_scratch_alloc_offset(sizeof(void *));
+
+	return (nacl_shmem_offset) ? 0 : SBI_ENOMEM;
+}
+
+struct sbi_ecall_extension ecall_nacl = {
+	.extid_start = SBI_EXT_NACL,
+	.extid_end = SBI_EXT_NACL,
+	.handle = sbi_ecall_nacl_handler,
+	.probe = sbi_ecall_nacl_probe,
+};
@@ -0,0 +1,190 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/riscv_locks.h>
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_sta.h>
+#include <sbi/sbi_timer.h>
+#include <sbi/sbi_trap.h>
+
+_Static_assert(SBI_STA_SHMEM_SIZE == 64,
+	       "STA shared memory layout does not match the SBI specification");
+
+struct sbi_sta_hart_state {
+	/* Serializes updates of the shared record */
+	spinlock_t lock;
+	/* Registered steal-time record (NULL if none) */
+	struct sbi_sta_struct *shmem;
+};
+
+static unsigned long sta_state_offset;
+
+static struct sbi_sta_hart_state *sta_hartid2state(u32 hartid)
+{
+	struct sbi_scratch *scratch = sbi_hartid_to_scratch(hartid);
+
+	if (!scratch || !sta_state_offset)
+		return NULL;
+
+	return sbi_scratch_offset_ptr(scratch, sta_state_offset);
+}
+
+/* The STA record holds steal time in nanoseconds */
+static u64 sta_ticks_to_ns(u64 ticks)
+{
+	const struct sbi_timer_device *tdev = sbi_timer_get_device();
+	u64 freq;
+
+	if (!tdev || !tdev->timer_freq)
+		return 0;
+
+	/* Split the conversion so that long intervals do not overflow */
+	freq = tdev->timer_freq;
+	return (ticks / freq) * 1000000000ULL +
+	       ((ticks % freq) * 1000000000ULL) / freq;
+}
+
+static void sta_update(struct sbi_sta_struct *st, u64 delta,
+		       int preempted)
+{
+	/* Odd sequence tells readers that an update is in progress */
+	st->sequence++;
+	smp_wmb();
+
+	st->steal += delta;
+	if (preempted >= 0)
+		st->preempted = preempted;
+
+	smp_wmb();
+	st->sequence++;
+}
+
+static void sta_account(u32 hartid, u64 delta, int preempted)
+{
+	struct sbi_sta_hart_state *ss = sta_hartid2state(hartid);
+
+	if (!ss || !ss->shmem)
+		return;
+
+	spin_lock(&ss->lock);
+	if (ss->shmem)
+		sta_update(ss->shmem, delta, preempted);
+	spin_unlock(&ss->lock);
+}
+
+void sbi_sta_steal_time_add(u32 hartid, u64 delta_ns)
+{
+	if (delta_ns)
+		sta_account(hartid, delta_ns, -1);
+}
+
+void sbi_sta_set_preempted(u32 hartid, bool preempted)
+{
+	sta_account(hartid, 0, (preempted) ? 1 : 0);
+}
+
+u64 sbi_sta_irq_enter(const struct sbi_trap_regs *regs)
+{
+	struct sbi_sta_hart_state *ss = sta_hartid2state(current_hartid());
+
+	/* Only interrupts taken away from S/U-mode steal guest time */
+	if (!ss || !ss->shmem ||
+	    ((regs->mstatus & MSTATUS_MPP) >> MSTATUS_MPP_SHIFT) == PRV_M)
+		return 0;
+
+	return sbi_timer_value();
+}
+
+void sbi_sta_irq_exit(u64 start)
+{
+	u64 now;
+
+	if (!start)
+		return;
+
+	now = sbi_timer_value();
+	if (start < now)
+		sbi_sta_steal_time_add(current_hartid(),
+				       sta_ticks_to_ns(now - start));
+}
+
+static int sta_set_shmem(unsigned long shmem_lo, unsigned long shmem_hi,
+			 unsigned long flags)
+{
+	struct sbi_sta_hart_state *ss = sta_hartid2state(current_hartid());
+	struct sbi_sta_struct *shmem;
+
+	if (!ss)
+		return SBI_ENOTSUPP;
+
+	if (flags)
+		return SBI_EINVAL;
+
+	/* All-ones address disables the steal-time shared memory */
+	if (shmem_lo == -1UL && shmem_hi == -1UL) {
+		shmem = NULL;
+		goto done;
+	}
+
+	if (shmem_lo & (SBI_STA_SHMEM_SIZE - 1))
+		return SBI_EINVAL;
+
+	/* Only shared memory addressable by M-mode is supported */
+	if (shmem_hi ||
+	    !sbi_domain_check_addr_range(sbi_domain_thishart_ptr(), shmem_lo,
+					 SBI_STA_SHMEM_SIZE, PRV_S,
+					 SBI_DOMAIN_READ | SBI_DOMAIN_WRITE))
+		return SBI_EINVALID_ADDR;
+
+	shmem = (struct sbi_sta_struct *)shmem_lo;
+
+done:
+	spin_lock(&ss->lock);
+	ss->shmem = shmem;
+	spin_unlock(&ss->lock);
+
+	return 0;
+}
+
+static int sbi_ecall_sta_handler(unsigned long extid, unsigned long funcid,
+				 const struct sbi_trap_regs *regs,
+				 unsigned long *out_val,
+				 struct sbi_trap_info *out_trap)
+{
+	if (funcid == SBI_EXT_STA_STEAL_TIME_SET_SHMEM)
+		return sta_set_shmem(regs->a0, regs->a1, regs->a2);
+
+	return SBI_ENOTSUPP;
+}
+
+int sbi_sta_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct sbi_sta_hart_state *ss;
+
+	if (cold_boot)
+		sta_state_offset = sbi_scratch_alloc_offset(sizeof(*ss));
+	if (!sta_state_offset)
+		return SBI_ENOMEM;
+
+	/* The registered record is kept across warm resume */
+	ss = sbi_scratch_offset_ptr(scratch, sta_state_offset);
+	SPIN_LOCK_INIT(ss->lock);
+
+	return 0;
+}
+
+struct sbi_ecall_extension ecall_sta = {
+	.extid_start = SBI_EXT_STA,
+	.extid_end = SBI_EXT_STA,
+	.handle = sbi_ecall_sta_handler,
+};
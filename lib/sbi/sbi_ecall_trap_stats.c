@@ -0,0 +1,58 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_trap.h>
+#include <sbi/sbi_trap_stats.h>
+
+static int sbi_ecall_trap_stats_handler(unsigned long extid,
+					unsigned long funcid,
+					const struct sbi_trap_regs *regs,
+					unsigned long *out_val,
+					struct sbi_trap_info *out_trap)
+{
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+	int ret = 0;
+
+	switch (funcid) {
+	case SBI_EXT_TRAP_STATS_DUMP:
+	case SBI_EXT_TRAP_STATS_RESET:
+		/* Statistics of all HARTs are only visible to the root domain */
+		if (dom != &root) {
+			ret = SBI_EDENIED;
+			break;
+		}
+		if (funcid == SBI_EXT_TRAP_STATS_DUMP)
+			sbi_trap_stats_dump();
+		else
+			sbi_trap_stats_reset();
+		break;
+	case SBI_EXT_TRAP_STATS_READ:
+		/* Other domains can only read HARTs assigned to them */
+		if (dom != &root &&
+		    !sbi_domain_is_assigned_hart(dom, regs->a0)) {
+			ret = SBI_EDENIED;
+			break;
+		}
+		ret = sbi_trap_stats_read(regs->a0, regs->a1, regs->a2,
+					  out_val);
+		break;
+	default:
+		ret = SBI_ENOTSUPP;
+		break;
+	}
+
+	return ret;
+}
+
+struct sbi_ecall_extension ecall_trap_stats = {
+	.extid_start = SBI_EXT_OPENSBI_TRAP_STATS,
+	.extid_end = SBI_EXT_OPENSBI_TRAP_STATS,
+	.handle = sbi_ecall_trap_stats_handler,
+};
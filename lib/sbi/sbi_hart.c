@@ -390,6 +390,22 @@ static inline void __sbi_hart_update_extension(
 		hfeatures->extensions &= ~BIT(ext);
 }
 
+static void hart_update_fast_flags(struct sbi_scratch *scratch)
+{
+	struct sbi_hart_features *hfeatures =
+			sbi_scratch_offset_ptr(scratch, hart_features_offset);
+	unsigned long flags = 0;
+
+	if (hfeatures->extensions & BIT(SBI_HART_EXT_SMAIA))
+		flags |= SBI_HART_FAST_SMAIA;
+	if (hfeatures->extensions & BIT(SBI_HART_EXT_SSTC))
+		flags |= SBI_HART_FAST_SSTC;
+	if (misa_extension('H'))
+		flags |= SBI_HART_FAST_HEXT;
+
+	scratch->fast_flags = flags;
+}
+
 /**
  * Enable/Disable a particular hart extension
  *
@@ -405,6 +421,7 @@ void sbi_hart_update_extension(struct sbi_scratch *scratch,
 			sbi_scratch_offset_ptr(scratch, hart_features_offset);
 
 	__sbi_hart_update_extension(hfeatures, ext, enable);
+	hart_update_fast_flags(scratch);
 }
 
 /**
@@ -740,6 +757,8 @@ int sbi_hart_init(struct sbi_scratch *scratch, bool cold_boot)
 	if (rc)
 		return rc;
 
+	hart_update_fast_flags(scratch);
+
 	return sbi_hart_reinit(scratch);
 }
 
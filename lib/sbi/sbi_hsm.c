@@ -33,6 +33,7 @@ static unsigned long hart_data_offset;
 struct sbi_hsm_data {
 	atomic_t state;
 	unsigned long suspend_type;
+	bool system_suspend;
 	unsigned long saved_mie;
 	unsigned long saved_mip;
 };
@@ -376,7 +377,11 @@ void sbi_hsm_hart_resume_start(struct sbi_scratch *scratch)
 		sbi_hart_hang();
 	}
 
-	hsm_device_hart_resume();
+	if (hdata->system_suspend) {
+		hdata->system_suspend = FALSE;
+		sbi_system_resume();
+	} else
+		hsm_device_hart_resume();
 }
 
 void sbi_hsm_hart_resume_finish(struct sbi_scratch *scratch)
@@ -495,3 +500,38 @@ fail_restore_state:
 
 	return ret;
 }
+
+int sbi_hsm_hart_system_suspend_prepare(struct sbi_scratch *scratch)
+{
+	int oldstate;
+	struct sbi_hsm_data *hdata = sbi_scratch_offset_ptr(scratch,
+							    hart_data_offset);
+
+	/* Directly move from STARTED to SUSPENDED state */
+	oldstate = atomic_cmpxchg(&hdata->state, SBI_HSM_STATE_STARTED,
+				  SBI_HSM_STATE_SUSPENDED);
+	if (oldstate != SBI_HSM_STATE_STARTED)
+		return SBI_EDENIED;
+
+	hdata->suspend_type = SBI_HSM_SUSPEND_NON_RET_DEFAULT;
+	hdata->system_suspend = TRUE;
+	__sbi_hsm_suspend_non_ret_save(scratch);
+
+	return 0;
+}
+
+void sbi_hsm_hart_system_suspend_cancel(struct sbi_scratch *scratch)
+{
+	int oldstate;
+	struct sbi_hsm_data *hdata = sbi_scratch_offset_ptr(scratch,
+							    hart_data_offset);
+
+	hdata->system_suspend = FALSE;
+	oldstate = atomic_cmpxchg(&hdata->state, SBI_HSM_STATE_SUSPENDED,
+				  SBI_HSM_STATE_STARTED);
+	if (oldstate != SBI_HSM_STATE_SUSPENDED) {
+		sbi_printf("%s: ERR: The hart is in invalid state [%u]\n",
+			   __func__, oldstate);
+		sbi_hart_hang();
+	}
+}
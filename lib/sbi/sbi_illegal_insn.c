@@ -15,6 +15,7 @@
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_illegal_insn.h>
 #include <sbi/sbi_pmu.h>
+#include <sbi/sbi_timer.h>
 #include <sbi/sbi_trap.h>
 #include <sbi/sbi_unpriv.h>
 #include <sbi/sbi_console.h>
@@ -137,6 +138,43 @@ static const illegal_insn_func illegal_insn_table[32] = {
 	truly_illegal_insn  /* 31 */
 };
 
+/*
+ * Emulate rdtime/rdtimeh without going through the generic CSR
+ * emulation. These are the most frequent illegal instruction traps
+ * on platforms which don't implement the TIME CSR in hardware.
+ */
+static inline bool rdtime_fast_insn(ulong insn, struct sbi_trap_regs *regs)
+{
+	u64 val;
+	ulong match = insn & INSN_MASK_RDTIME;
+#if __riscv_xlen == 32
+	bool virt = (regs->mstatusH & MSTATUSH_MPV) ? TRUE : FALSE;
+
+	if (match != INSN_MATCH_RDTIME && match != INSN_MATCH_RDTIMEH)
+		return FALSE;
+#else
+	bool virt = (regs->mstatus & MSTATUS_MPV) ? TRUE : FALSE;
+
+	if (match != INSN_MATCH_RDTIME)
+		return FALSE;
+#endif
+
+	/* CSR accesses from M-mode are reported by the generic path */
+	if ((regs->mstatus & MSTATUS_MPP) == (PRV_M << MSTATUS_MPP_SHIFT))
+		return FALSE;
+
+	val = (virt) ? sbi_timer_virt_value() : sbi_timer_value();
+#if __riscv_xlen == 32
+	if (match == INSN_MATCH_RDTIMEH)
+		val >>= 32;
+#endif
+
+	SET_RD(insn, regs, (ulong)val);
+	regs->mepc += 4;
+
+	return TRUE;
+}
+
 int sbi_illegal_insn_handler(ulong insn, struct sbi_trap_regs *regs)
 {
 	struct sbi_trap_info uptrap;
@@ -163,5 +201,8 @@ int sbi_illegal_insn_handler(ulong insn, struct sbi_trap_regs *regs)
 			return truly_illegal_insn(insn, regs);
 	}
 
+	if (rdtime_fast_insn(insn, regs))
+		return 0;
+
 	return illegal_insn_table[(insn & 0x7c) >> 2](insn, regs);
 }
@@ -10,7 +10,6 @@
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_atomic.h>
 #include <sbi/riscv_barrier.h>
-#include <sbi/riscv_locks.h>
 #include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
 #include <sbi/sbi_ecall.h>
@@ -19,8 +18,11 @@
 #include <sbi/sbi_hsm.h>
 #include <sbi/sbi_ipi.h>
 #include <sbi/sbi_irqchip.h>
+#include <sbi/sbi_misaligned_ldst.h>
+#include <sbi/sbi_nacl.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_pmu.h>
+#include <sbi/sbi_sta.h>
 #include <sbi/sbi_system.h>
 #include <sbi/sbi_string.h>
 #include <sbi/sbi_timer.h>
@@ -160,14 +162,55 @@ static void sbi_boot_print_hart(struct sbi_scratch *scratch, u32 hartid)
 	sbi_hart_delegation_dump(scratch, "Boot HART ", "         ");
 }
 
-static spinlock_t coldboot_lock = SPIN_LOCK_INITIALIZER;
 static struct sbi_hartmask coldboot_wait_hmask = { 0 };
+static struct sbi_hartmask coldboot_wake_hmask = { 0 };
+static struct sbi_hartmask coldboot_wake_pending_hmask = { 0 };
 
 static unsigned long coldboot_done;
+static unsigned long coldboot_wake_ready;
+
+/*
+ * Without a multicast IPI the waiting HARTs are woken up in a tree:
+ * the coldboot HART is node 0, the waiting HARTs in coldboot_wake_hmask
+ * are nodes 1..N in ascending HART id order, and node k wakes up nodes
+ * (k * COLDBOOT_WAKE_FANOUT + 1) to (k * COLDBOOT_WAKE_FANOUT +
+ * COLDBOOT_WAKE_FANOUT).
+ */
+#define COLDBOOT_WAKE_FANOUT	4
+
+static void coldboot_wake_children(u32 node)
+{
+	u32 i, n = 0;
+	u32 first = node * COLDBOOT_WAKE_FANOUT + 1;
+	u32 last = first + COLDBOOT_WAKE_FANOUT;
+
+	sbi_hartmask_for_each_hart(i, &coldboot_wake_hmask) {
+		n++;
+		if (n < first)
+			continue;
+		if (n >= last)
+			break;
+		sbi_ipi_raw_send(i);
+	}
+}
+
+static u32 coldboot_wake_node(u32 hartid)
+{
+	u32 i, n = 0;
+
+	sbi_hartmask_for_each_hart(i, &coldboot_wake_hmask) {
+		n++;
+		if (i == hartid)
+			return n;
+	}
+
+	return 0;
+}
 
 static void wait_for_coldboot(struct sbi_scratch *scratch, u32 hartid)
 {
 	unsigned long saved_mie, cmip;
+	u32 node;
 
 	/* Save MIE CSR */
 	saved_mie = csr_read(CSR_MIE);
@@ -175,14 +218,12 @@ static void wait_for_coldboot(struct sbi_scratch *scratch, u32 hartid)
 	/* Set MSIE and MEIE bits to receive IPI */
 	csr_set(CSR_MIE, MIP_MSIP | MIP_MEIP);
 
-	/* Acquire coldboot lock */
-	spin_lock(&coldboot_lock);
-
-	/* Mark current HART as waiting */
-	sbi_hartmask_set_hart(hartid, &coldboot_wait_hmask);
-
-	/* Release coldboot lock */
-	spin_unlock(&coldboot_lock);
+	/*
+	 * Mark current HART as waiting. The AMO is fully ordered so either
+	 * the coldboot HART sees this HART as waiting or this HART sees
+	 * coldboot as done below.
+	 */
+	atomic_raw_set_bit(hartid, sbi_hartmask_bits(&coldboot_wait_hmask));
 
 	/* Wait for coldboot to finish using WFI */
 	while (!__smp_load_acquire(&coldboot_done)) {
@@ -192,14 +233,22 @@ static void wait_for_coldboot(struct sbi_scratch *scratch, u32 hartid)
 		 } while (!(cmip & (MIP_MSIP | MIP_MEIP)));
 	};
 
-	/* Acquire coldboot lock */
-	spin_lock(&coldboot_lock);
-
 	/* Unmark current HART as waiting */
-	sbi_hartmask_clear_hart(hartid, &coldboot_wait_hmask);
+	atomic_raw_clear_bit(hartid, sbi_hartmask_bits(&coldboot_wait_hmask));
 
-	/* Release coldboot lock */
-	spin_unlock(&coldboot_lock);
+	/*
+	 * If current HART is part of the wake up tree then pass the wake
+	 * up on to its children, but only once since this path is also
+	 * taken on warm resume.
+	 */
+	while (!__smp_load_acquire(&coldboot_wake_ready))
+		cpu_relax();
+	if (atomic_raw_test_and_clear_bit(hartid,
+			sbi_hartmask_bits(&coldboot_wake_pending_hmask))) {
+		node = coldboot_wake_node(hartid);
+		if (node)
+			coldboot_wake_children(node);
+	}
 
 	/* Restore MIE CSR */
 	csr_write(CSR_MIE, saved_mie);
@@ -216,21 +265,35 @@ static void wait_for_coldboot(struct sbi_scratch *scratch, u32 hartid)
 
 static void wake_coldboot_harts(struct sbi_scratch *scratch, u32 hartid)
 {
+	u32 i;
+	struct sbi_hartmask wake_hmask = { 0 };
+
 	/* Mark coldboot done */
 	__smp_store_release(&coldboot_done, 1);
 
-	/* Acquire coldboot lock */
-	spin_lock(&coldboot_lock);
+	/* Pairs with the AMO setting the waiting bit in wait_for_coldboot() */
+	smp_mb();
 
-	/* Send an IPI to all HARTs waiting for coldboot */
-	for (u32 i = 0; i <= sbi_scratch_last_hartid(); i++) {
+	/* Snapshot HARTs waiting for coldboot */
+	for (i = 0; i <= sbi_scratch_last_hartid(); i++) {
 		if ((i != hartid) &&
 		    sbi_hartmask_test_hart(i, &coldboot_wait_hmask))
-			sbi_ipi_raw_send(i);
+			sbi_hartmask_set_hart(i, &wake_hmask);
 	}
 
-	/* Release coldboot lock */
-	spin_unlock(&coldboot_lock);
+	/* Wake up all waiting HARTs at once if the IPI device can */
+	if (!sbi_ipi_raw_send_mask(&wake_hmask)) {
+		__smp_store_release(&coldboot_wake_ready, 1);
+		return;
+	}
+
+	/* Otherwise publish the wake up tree and wake up our children */
+	sbi_hartmask_or(&coldboot_wake_hmask, &coldboot_wake_hmask,
+			&wake_hmask);
+	sbi_hartmask_or(&coldboot_wake_pending_hmask,
+			&coldboot_wake_pending_hmask, &wake_hmask);
+	__smp_store_release(&coldboot_wake_ready, 1);
+	coldboot_wake_children(0);
 }
 
 static unsigned long init_count_offset;
@@ -267,6 +330,10 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_misaligned_ldst_init(scratch, TRUE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_console_init(scratch);
 	if (rc)
 		sbi_hart_hang();
@@ -302,6 +369,18 @@ static void __noreturn init_coldboot(struct sbi_scratch *scratch, u32 hartid)
 		sbi_hart_hang();
 	}
 
+	rc = sbi_sta_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: sta init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
+	rc = sbi_nacl_init(scratch, TRUE);
+	if (rc) {
+		sbi_printf("%s: nacl init failed (error %d)\n", __func__, rc);
+		sbi_hart_hang();
+	}
+
 	rc = sbi_ecall_init();
 	if (rc) {
 		sbi_printf("%s: ecall init failed (error %d)\n", __func__, rc);
@@ -376,6 +455,10 @@ static void init_warm_startup(struct sbi_scratch *scratch, u32 hartid)
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_misaligned_ldst_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_pmu_init(scratch, FALSE);
 	if (rc)
 		sbi_hart_hang();
@@ -396,6 +479,14 @@ static void init_warm_startup(struct sbi_scratch *scratch, u32 hartid)
 	if (rc)
 		sbi_hart_hang();
 
+	rc = sbi_sta_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
+	rc = sbi_nacl_init(scratch, FALSE);
+	if (rc)
+		sbi_hart_hang();
+
 	rc = sbi_hart_pmp_configure(scratch);
 	if (rc)
 		sbi_hart_hang();
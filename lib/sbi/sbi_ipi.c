@@ -31,18 +31,13 @@ static unsigned long ipi_data_off;
 static const struct sbi_ipi_device *ipi_dev = NULL;
 static const struct sbi_ipi_event_ops *ipi_ops_array[SBI_IPI_EVENT_MAX];
 
-static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
-			u32 event, void *data)
+static int sbi_ipi_update(struct sbi_scratch *scratch, u32 remote_hartid,
+			  u32 event, void *data)
 {
 	int ret;
 	struct sbi_scratch *remote_scratch = NULL;
 	struct sbi_ipi_data *ipi_data;
-	const struct sbi_ipi_event_ops *ipi_ops;
-
-	if ((SBI_IPI_EVENT_MAX <= event) ||
-	    !ipi_ops_array[event])
-		return SBI_EINVAL;
-	ipi_ops = ipi_ops_array[event];
+	const struct sbi_ipi_event_ops *ipi_ops = ipi_ops_array[event];
 
 	remote_scratch = sbi_hartid_to_scratch(remote_hartid);
 	if (!remote_scratch)
@@ -57,59 +52,89 @@ static int sbi_ipi_send(struct sbi_scratch *scratch, u32 remote_hartid,
 			return ret;
 	}
 
-	/*
-	 * Set IPI type on remote hart's scratch area and
-	 * trigger the interrupt
-	 */
+	/* Set IPI type on remote hart's scratch area */
 	atomic_raw_set_bit(event, &ipi_data->ipi_type);
-	smp_wmb();
-
-	if (ipi_dev && ipi_dev->ipi_send)
-		ipi_dev->ipi_send(remote_hartid);
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_IPI_SENT);
 
-	if (ipi_ops->sync)
-		ipi_ops->sync(scratch);
-
 	return 0;
 }
 
+static void sbi_ipi_trigger(const struct sbi_hartmask *mask)
+{
+	u32 i;
+
+	if (!ipi_dev)
+		return;
+
+	/* Make IPI type visible before triggering the interrupts */
+	smp_wmb();
+
+	if (ipi_dev->ipi_send_mask) {
+		ipi_dev->ipi_send_mask(mask);
+	} else if (ipi_dev->ipi_send) {
+		sbi_hartmask_for_each_hart(i, mask)
+			ipi_dev->ipi_send(i);
+	}
+}
+
 /**
  * As this this function only handlers scalar values of hart mask, it must be
  * set to all online harts if the intention is to send IPIs to all the harts.
  * If hmask is zero, no IPIs will be sent.
+ *
+ * The IPI type is first updated on all target HARTs, then the IPIs are
+ * triggered together and the optional sync callback of the event is called
+ * only once after that so that remote HARTs can process the event in
+ * parallel.
  */
 int sbi_ipi_send_many(ulong hmask, ulong hbase, u32 event, void *data)
 {
 	int rc;
 	ulong i, m;
+	struct sbi_hartmask target_mask;
+	const struct sbi_ipi_event_ops *ipi_ops;
 	struct sbi_domain *dom = sbi_domain_thishart_ptr();
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
+	if ((SBI_IPI_EVENT_MAX <= event) ||
+	    !ipi_ops_array[event])
+		return SBI_EINVAL;
+	ipi_ops = ipi_ops_array[event];
+
+	SBI_HARTMASK_INIT(&target_mask);
+
 	if (hbase != -1UL) {
 		rc = sbi_hsm_hart_interruptible_mask(dom, hbase, &m);
 		if (rc)
 			return rc;
 		m &= hmask;
 
-		/* Send IPIs */
+		/* Update IPI type */
 		for (i = hbase; m; i++, m >>= 1) {
-			if (m & 1UL)
-				sbi_ipi_send(scratch, i, event, data);
+			if ((m & 1UL) &&
+			    !sbi_ipi_update(scratch, i, event, data))
+				sbi_hartmask_set_hart(i, &target_mask);
 		}
 	} else {
 		hbase = 0;
 		while (!sbi_hsm_hart_interruptible_mask(dom, hbase, &m)) {
-			/* Send IPIs */
+			/* Update IPI type */
 			for (i = hbase; m; i++, m >>= 1) {
-				if (m & 1UL)
-					sbi_ipi_send(scratch, i, event, data);
+				if ((m & 1UL) &&
+				    !sbi_ipi_update(scratch, i, event, data))
+					sbi_hartmask_set_hart(i, &target_mask);
 			}
 			hbase += BITS_PER_LONG;
 		}
 	}
 
+	/* Send IPIs */
+	sbi_ipi_trigger(&target_mask);
+
+	if (ipi_ops->sync)
+		ipi_ops->sync(scratch);
+
 	return 0;
 }
 
@@ -217,6 +242,15 @@ int sbi_ipi_raw_send(u32 target_hart)
 	return 0;
 }
 
+int sbi_ipi_raw_send_mask(const struct sbi_hartmask *target_mask)
+{
+	if (!ipi_dev || !ipi_dev->ipi_send_mask)
+		return SBI_ENOTSUPP;
+
+	ipi_dev->ipi_send_mask(target_mask);
+	return 0;
+}
+
 const struct sbi_ipi_device *sbi_ipi_get_device(void)
 {
 	return ipi_dev;
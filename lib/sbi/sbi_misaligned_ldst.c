@@ -13,15 +13,218 @@
 #include <sbi/sbi_error.h>
 #include <sbi/sbi_misaligned_ldst.h>
 #include <sbi/sbi_pmu.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
 #include <sbi/sbi_trap.h>
 #include <sbi/sbi_unpriv.h>
 
 union reg_data {
 	u8 data_bytes[8];
 	ulong data_ulong;
+	ulong data_words[sizeof(u64) / sizeof(ulong)];
 	u64 data_u64;
 };
 
+/* Flags of decoded misaligned load/store operation */
+#define MISALIGNED_OP_SIGNED		(1U << 0)
+#define MISALIGNED_OP_FP		(1U << 1)
+#define MISALIGNED_OP_STORE		(1U << 2)
+/* Decoder only: instruction is reserved when rd == x0 */
+#define MISALIGNED_OP_RD_NONZERO	(1U << 3)
+
+/* Location of the data register number in the instruction */
+enum misaligned_op_reg {
+	MISALIGNED_REG_RD = 0,
+	MISALIGNED_REG_RS2,
+	MISALIGNED_REG_RS2S,
+	MISALIGNED_REG_RS2C,
+};
+
+struct misaligned_insn_desc {
+	ulong mask;
+	ulong match;
+	u8 len;
+	u8 flags;
+	u8 reg;
+};
+
+#define MISALIGNED_INSN(__name, __len, __flags, __reg)	\
+	{ INSN_MASK_##__name, INSN_MATCH_##__name, __len, __flags, __reg }
+
+static const struct misaligned_insn_desc misaligned_load_insns[] = {
+	MISALIGNED_INSN(LW, 4, MISALIGNED_OP_SIGNED, MISALIGNED_REG_RD),
+#if __riscv_xlen == 64
+	MISALIGNED_INSN(LD, 8, MISALIGNED_OP_SIGNED, MISALIGNED_REG_RD),
+	MISALIGNED_INSN(LWU, 4, 0, MISALIGNED_REG_RD),
+#endif
+#ifdef __riscv_flen
+	MISALIGNED_INSN(FLD, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RD),
+	MISALIGNED_INSN(FLW, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RD),
+#endif
+	MISALIGNED_INSN(LH, 2, MISALIGNED_OP_SIGNED, MISALIGNED_REG_RD),
+	MISALIGNED_INSN(LHU, 2, 0, MISALIGNED_REG_RD),
+#if __riscv_xlen >= 64
+	MISALIGNED_INSN(C_LD, 8, MISALIGNED_OP_SIGNED, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_LDSP, 8,
+			MISALIGNED_OP_SIGNED | MISALIGNED_OP_RD_NONZERO,
+			MISALIGNED_REG_RD),
+#endif
+	MISALIGNED_INSN(C_LW, 4, MISALIGNED_OP_SIGNED, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_LWSP, 4,
+			MISALIGNED_OP_SIGNED | MISALIGNED_OP_RD_NONZERO,
+			MISALIGNED_REG_RD),
+#ifdef __riscv_flen
+	MISALIGNED_INSN(C_FLD, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_FLDSP, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RD),
+#if __riscv_xlen == 32
+	MISALIGNED_INSN(C_FLW, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_FLWSP, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RD),
+#endif
+#endif
+};
+
+static const struct misaligned_insn_desc misaligned_store_insns[] = {
+	MISALIGNED_INSN(SW, 4, 0, MISALIGNED_REG_RS2),
+#if __riscv_xlen == 64
+	MISALIGNED_INSN(SD, 8, 0, MISALIGNED_REG_RS2),
+#endif
+#ifdef __riscv_flen
+	MISALIGNED_INSN(FSD, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RS2),
+	MISALIGNED_INSN(FSW, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RS2),
+#endif
+	MISALIGNED_INSN(SH, 2, 0, MISALIGNED_REG_RS2),
+#if __riscv_xlen >= 64
+	MISALIGNED_INSN(C_SD, 8, 0, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_SDSP, 8, MISALIGNED_OP_RD_NONZERO,
+			MISALIGNED_REG_RS2C),
+#endif
+	MISALIGNED_INSN(C_SW, 4, 0, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_SWSP, 4, MISALIGNED_OP_RD_NONZERO,
+			MISALIGNED_REG_RS2C),
+#ifdef __riscv_flen
+	MISALIGNED_INSN(C_FSD, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_FSDSP, 8, MISALIGNED_OP_FP, MISALIGNED_REG_RS2C),
+#if __riscv_xlen == 32
+	MISALIGNED_INSN(C_FSW, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RS2S),
+	MISALIGNED_INSN(C_FSWSP, 4, MISALIGNED_OP_FP, MISALIGNED_REG_RS2C),
+#endif
+#endif
+};
+
+#undef MISALIGNED_INSN
+
+/** Decoded misaligned load/store operation */
+struct misaligned_op {
+	u8 len;
+	u8 flags;
+	/* Number of the data register (GPR or FPR) */
+	u8 reg;
+};
+
+/* Number of entries in the per-HART decoded instruction cache */
+#define MISALIGNED_CACHE_ENTRIES	4
+
+struct misaligned_cache_entry {
+	ulong epc;
+	ulong insn;
+	struct misaligned_op op;
+};
+
+/*
+ * Per-HART cache of decoded operations indexed by trap PC. Entries
+ * are tagged with both the PC and the instruction bits so a stale
+ * entry (e.g. after code was modified or remapped) is never used.
+ */
+static unsigned long misaligned_cache_offset;
+
+static struct misaligned_cache_entry *misaligned_cache_lookup(ulong epc,
+							      ulong insn,
+							      u8 store)
+{
+	struct misaligned_cache_entry *cache, *ce;
+
+	if (!misaligned_cache_offset)
+		return NULL;
+
+	cache = sbi_scratch_thishart_offset_ptr(misaligned_cache_offset);
+	ce = &cache[(epc >> 1) & (MISALIGNED_CACHE_ENTRIES - 1)];
+	if (ce->epc == epc && ce->insn == insn && ce->op.len &&
+	    (ce->op.flags & MISALIGNED_OP_STORE) == store)
+		return ce;
+
+	return NULL;
+}
+
+static void misaligned_cache_update(ulong epc, ulong insn,
+				    const struct misaligned_op *op)
+{
+	struct misaligned_cache_entry *cache, *ce;
+
+	if (!misaligned_cache_offset)
+		return;
+
+	cache = sbi_scratch_thishart_offset_ptr(misaligned_cache_offset);
+	ce = &cache[(epc >> 1) & (MISALIGNED_CACHE_ENTRIES - 1)];
+	ce->epc = epc;
+	ce->insn = insn;
+	ce->op = *op;
+}
+
+static int misaligned_decode(ulong epc, ulong insn, bool store,
+			     struct misaligned_op *op)
+{
+	u32 i, count;
+	const struct misaligned_insn_desc *desc;
+	struct misaligned_cache_entry *ce;
+	u8 store_flag = (store) ? MISALIGNED_OP_STORE : 0;
+
+	ce = misaligned_cache_lookup(epc, insn, store_flag);
+	if (ce) {
+		*op = ce->op;
+		return 0;
+	}
+
+	if (store) {
+		desc = misaligned_store_insns;
+		count = array_size(misaligned_store_insns);
+	} else {
+		desc = misaligned_load_insns;
+		count = array_size(misaligned_load_insns);
+	}
+
+	for (i = 0; i < count; i++, desc++) {
+		if ((insn & desc->mask) != desc->match)
+			continue;
+		if ((desc->flags & MISALIGNED_OP_RD_NONZERO) &&
+		    !((insn >> SH_RD) & 0x1f))
+			continue;
+		break;
+	}
+	if (i == count)
+		return SBI_ENOTSUPP;
+
+	op->len = desc->len;
+	op->flags = (desc->flags & ~MISALIGNED_OP_RD_NONZERO) | store_flag;
+	switch (desc->reg) {
+	case MISALIGNED_REG_RS2:
+		op->reg = (insn >> SH_RS2) & 0x1f;
+		break;
+	case MISALIGNED_REG_RS2S:
+		op->reg = RVC_RS2S(insn);
+		break;
+	case MISALIGNED_REG_RS2C:
+		op->reg = (insn >> SH_RS2C) & 0x1f;
+		break;
+	default:
+		op->reg = (insn >> SH_RD) & 0x1f;
+		break;
+	}
+
+	misaligned_cache_update(epc, insn, op);
+
+	return 0;
+}
+
 static ulong sbi_misaligned_tinst_fixup(ulong orig_tinst, ulong new_tinst,
 					ulong addr_offset)
 {
@@ -37,10 +240,11 @@ static ulong sbi_misaligned_tinst_fixup(ulong orig_tinst, ulong new_tinst,
 int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 				struct sbi_trap_regs *regs)
 {
-	ulong insn, insn_len;
+	ulong insn, insn_len, done;
 	union reg_data val;
 	struct sbi_trap_info uptrap;
-	int i, fp = 0, shift = 0, len = 0;
+	struct misaligned_op op;
+	int i, rc, shift, len;
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_MISALIGNED_LOAD);
 
@@ -64,66 +268,12 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 		insn_len = INSN_LEN(insn);
 	}
 
-	if ((insn & INSN_MASK_LW) == INSN_MATCH_LW) {
-		len   = 4;
-		shift = 8 * (sizeof(ulong) - len);
-#if __riscv_xlen == 64
-	} else if ((insn & INSN_MASK_LD) == INSN_MATCH_LD) {
-		len   = 8;
-		shift = 8 * (sizeof(ulong) - len);
-	} else if ((insn & INSN_MASK_LWU) == INSN_MATCH_LWU) {
-		len = 4;
-#endif
-#ifdef __riscv_flen
-	} else if ((insn & INSN_MASK_FLD) == INSN_MATCH_FLD) {
-		fp  = 1;
-		len = 8;
-	} else if ((insn & INSN_MASK_FLW) == INSN_MATCH_FLW) {
-		fp  = 1;
-		len = 4;
-#endif
-	} else if ((insn & INSN_MASK_LH) == INSN_MATCH_LH) {
-		len   = 2;
-		shift = 8 * (sizeof(ulong) - len);
-	} else if ((insn & INSN_MASK_LHU) == INSN_MATCH_LHU) {
-		len = 2;
-#if __riscv_xlen >= 64
-	} else if ((insn & INSN_MASK_C_LD) == INSN_MATCH_C_LD) {
-		len   = 8;
-		shift = 8 * (sizeof(ulong) - len);
-		insn  = RVC_RS2S(insn) << SH_RD;
-	} else if ((insn & INSN_MASK_C_LDSP) == INSN_MATCH_C_LDSP &&
-		   ((insn >> SH_RD) & 0x1f)) {
-		len   = 8;
-		shift = 8 * (sizeof(ulong) - len);
-#endif
-	} else if ((insn & INSN_MASK_C_LW) == INSN_MATCH_C_LW) {
-		len   = 4;
-		shift = 8 * (sizeof(ulong) - len);
-		insn  = RVC_RS2S(insn) << SH_RD;
-	} else if ((insn & INSN_MASK_C_LWSP) == INSN_MATCH_C_LWSP &&
-		   ((insn >> SH_RD) & 0x1f)) {
-		len   = 4;
-		shift = 8 * (sizeof(ulong) - len);
-#ifdef __riscv_flen
-	} else if ((insn & INSN_MASK_C_FLD) == INSN_MATCH_C_FLD) {
-		fp   = 1;
-		len  = 8;
-		insn = RVC_RS2S(insn) << SH_RD;
-	} else if ((insn & INSN_MASK_C_FLDSP) == INSN_MATCH_C_FLDSP) {
-		fp  = 1;
-		len = 8;
-#if __riscv_xlen == 32
-	} else if ((insn & INSN_MASK_C_FLW) == INSN_MATCH_C_FLW) {
-		fp   = 1;
-		len  = 4;
-		insn = RVC_RS2S(insn) << SH_RD;
-	} else if ((insn & INSN_MASK_C_FLWSP) == INSN_MATCH_C_FLWSP) {
-		fp  = 1;
-		len = 4;
-#endif
-#endif
-	} else {
+	if (misaligned_decode(regs->mepc, insn, FALSE, &op)) {
+		/* Vector loads/stores are emulated element by element */
+		rc = sbi_misaligned_v_ldst_emulate(insn, regs);
+		if (rc != SBI_ENOTSUPP)
+			return rc;
+
 		uptrap.epc = regs->mepc;
 		uptrap.cause = CAUSE_MISALIGNED_LOAD;
 		uptrap.tval = addr;
@@ -133,20 +283,27 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 		return sbi_trap_redirect(regs, &uptrap);
 	}
 
+	len = op.len;
 	val.data_u64 = 0;
-	for (i = 0; i < len; i++) {
-		val.data_bytes[i] = sbi_load_u8((void *)(addr + i),
-						&uptrap);
+	for (i = 0; i < len; i += sizeof(ulong)) {
+		done = sbi_load_bytes((u8 *)(addr + i), len - i,
+				      &val.data_words[i / sizeof(ulong)],
+				      &uptrap);
 		if (uptrap.cause) {
 			uptrap.epc = regs->mepc;
 			uptrap.tinst = sbi_misaligned_tinst_fixup(
-				tinst, uptrap.tinst, i);
+				tinst, uptrap.tinst, i + done);
 			return sbi_trap_redirect(regs, &uptrap);
 		}
 	}
 
-	if (!fp)
+	/* Register accessors expect the register number in rd position */
+	insn = (ulong)op.reg << SH_RD;
+	if (!(op.flags & MISALIGNED_OP_FP)) {
+		shift = (op.flags & MISALIGNED_OP_SIGNED) ?
+			8 * (sizeof(ulong) - len) : 0;
 		SET_RD(insn, regs, ((long)(val.data_ulong << shift)) >> shift);
+	}
 #ifdef __riscv_flen
 	else if (len == 8)
 		SET_F64_RD(insn, regs, val.data_u64);
@@ -162,10 +319,11 @@ int sbi_misaligned_load_handler(ulong addr, ulong tval2, ulong tinst,
 int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 				 struct sbi_trap_regs *regs)
 {
-	ulong insn, insn_len;
+	ulong insn, insn_len, done;
 	union reg_data val;
 	struct sbi_trap_info uptrap;
-	int i, len = 0;
+	struct misaligned_op op;
+	int i, rc, len;
 
 	sbi_pmu_ctr_incr_fw(SBI_PMU_FW_MISALIGNED_STORE);
 
@@ -189,57 +347,12 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 		insn_len = INSN_LEN(insn);
 	}
 
-	val.data_ulong = GET_RS2(insn, regs);
+	if (misaligned_decode(regs->mepc, insn, TRUE, &op)) {
+		/* Vector loads/stores are emulated element by element */
+		rc = sbi_misaligned_v_ldst_emulate(insn, regs);
+		if (rc != SBI_ENOTSUPP)
+			return rc;
 
-	if ((insn & INSN_MASK_SW) == INSN_MATCH_SW) {
-		len = 4;
-#if __riscv_xlen == 64
-	} else if ((insn & INSN_MASK_SD) == INSN_MATCH_SD) {
-		len = 8;
-#endif
-#ifdef __riscv_flen
-	} else if ((insn & INSN_MASK_FSD) == INSN_MATCH_FSD) {
-		len	     = 8;
-		val.data_u64 = GET_F64_RS2(insn, regs);
-	} else if ((insn & INSN_MASK_FSW) == INSN_MATCH_FSW) {
-		len	       = 4;
-		val.data_ulong = GET_F32_RS2(insn, regs);
-#endif
-	} else if ((insn & INSN_MASK_SH) == INSN_MATCH_SH) {
-		len = 2;
-#if __riscv_xlen >= 64
-	} else if ((insn & INSN_MASK_C_SD) == INSN_MATCH_C_SD) {
-		len	       = 8;
-		val.data_ulong = GET_RS2S(insn, regs);
-	} else if ((insn & INSN_MASK_C_SDSP) == INSN_MATCH_C_SDSP &&
-		   ((insn >> SH_RD) & 0x1f)) {
-		len	       = 8;
-		val.data_ulong = GET_RS2C(insn, regs);
-#endif
-	} else if ((insn & INSN_MASK_C_SW) == INSN_MATCH_C_SW) {
-		len	       = 4;
-		val.data_ulong = GET_RS2S(insn, regs);
-	} else if ((insn & INSN_MASK_C_SWSP) == INSN_MATCH_C_SWSP &&
-		   ((insn >> SH_RD) & 0x1f)) {
-		len	       = 4;
-		val.data_ulong = GET_RS2C(insn, regs);
-#ifdef __riscv_flen
-	} else if ((insn & INSN_MASK_C_FSD) == INSN_MATCH_C_FSD) {
-		len	     = 8;
-		val.data_u64 = GET_F64_RS2S(insn, regs);
-	} else if ((insn & INSN_MASK_C_FSDSP) == INSN_MATCH_C_FSDSP) {
-		len	     = 8;
-		val.data_u64 = GET_F64_RS2C(insn, regs);
-#if __riscv_xlen == 32
-	} else if ((insn & INSN_MASK_C_FSW) == INSN_MATCH_C_FSW) {
-		len	       = 4;
-		val.data_ulong = GET_F32_RS2S(insn, regs);
-	} else if ((insn & INSN_MASK_C_FSWSP) == INSN_MATCH_C_FSWSP) {
-		len	       = 4;
-		val.data_ulong = GET_F32_RS2C(insn, regs);
-#endif
-#endif
-	} else {
 		uptrap.epc = regs->mepc;
 		uptrap.cause = CAUSE_MISALIGNED_STORE;
 		uptrap.tval = addr;
@@ -249,13 +362,27 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 		return sbi_trap_redirect(regs, &uptrap);
 	}
 
-	for (i = 0; i < len; i++) {
-		sbi_store_u8((void *)(addr + i), val.data_bytes[i],
-			     &uptrap);
+	len = op.len;
+	val.data_u64 = 0;
+	/* Register accessors expect the register number in rd position */
+	insn = (ulong)op.reg << SH_RD;
+	if (!(op.flags & MISALIGNED_OP_FP))
+		val.data_ulong = *REG_PTR(insn, SH_RD, regs);
+#ifdef __riscv_flen
+	else if (len == 8)
+		val.data_u64 = GET_F64_REG(insn, SH_RD, regs);
+	else
+		val.data_ulong = GET_F32_REG(insn, SH_RD, regs);
+#endif
+
+	for (i = 0; i < len; i += sizeof(ulong)) {
+		done = sbi_store_bytes((u8 *)(addr + i), len - i,
+				       val.data_words[i / sizeof(ulong)],
+				       &uptrap);
 		if (uptrap.cause) {
 			uptrap.epc = regs->mepc;
 			uptrap.tinst = sbi_misaligned_tinst_fixup(
-				tinst, uptrap.tinst, i);
+				tinst, uptrap.tinst, i + done);
 			return sbi_trap_redirect(regs, &uptrap);
 		}
 	}
@@ -264,3 +391,21 @@ int sbi_misaligned_store_handler(ulong addr, ulong tval2, ulong tinst,
 
 	return 0;
 }
+
+int sbi_misaligned_ldst_init(struct sbi_scratch *scratch, bool cold_boot)
+{
+	struct misaligned_cache_entry *cache;
+
+	if (cold_boot) {
+		misaligned_cache_offset = sbi_scratch_alloc_offset(
+			sizeof(*cache) * MISALIGNED_CACHE_ENTRIES);
+		if (!misaligned_cache_offset)
+			return SBI_ENOMEM;
+	}
+
+	/* Cached decodes may be stale after HART reset or resume */
+	cache = sbi_scratch_offset_ptr(scratch, misaligned_cache_offset);
+	sbi_memset(cache, 0, sizeof(*cache) * MISALIGNED_CACHE_ENTRIES);
+
+	return 0;
+}
@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/riscv_encoding.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_misaligned_ldst.h>
+#include <sbi/sbi_trap.h>
+#include <sbi/sbi_unpriv.h>
+
+#ifdef OPENSBI_CC_SUPPORT_VECTOR
+
+/* Largest VLEN allowed by the V-extension */
+#define VLEN_MAX			65536
+
+/* Largest element segment: 8 fields of 64-bit elements */
+#define VSEG_MAX_BYTES			(8 * sizeof(u64))
+
+#define vreg_access(__insn, __vreg, __ptr)				\
+	asm volatile(".option push\n"					\
+		     ".option arch, +v\n"				\
+		     #__insn " " #__vreg ", (%0)\n"			\
+		     ".option pop\n"					\
+		     : : "r"(__ptr) : "memory")
+
+static inline void vsetvl(ulong vl, ulong vtype)
+{
+	asm volatile(".option push\n"
+		     ".option arch, +v\n"
+		     "vsetvl x0, %0, %1\n"
+		     ".option pop\n"
+		     : : "r"(vl), "r"(vtype));
+}
+
+/*
+ * Bytes [pos, pos + size) of vector register 'which' are accessed as
+ * elements of the 8-register group containing it. This clobbers VL,
+ * VTYPE and VSTART so callers must restore them.
+ */
+static ulong vreg_setup(ulong vlenb, ulong which, ulong pos, ulong size)
+{
+	pos += (which % 8) * vlenb;
+
+	asm volatile(".option push\n"
+		     ".option arch, +v\n"
+		     "vsetvli x0, %0, e8, m8, tu, ma\n"
+		     ".option pop\n"
+		     : : "r"(pos + size));
+	csr_write(CSR_VSTART, pos);
+
+	return pos;
+}
+
+static void set_vreg(ulong vlenb, ulong which, ulong pos, ulong size,
+		     const u8 *bytes)
+{
+	bytes -= vreg_setup(vlenb, which, pos, size);
+
+	switch (which / 8) {
+	case 0:
+		vreg_access(vle8.v, v0, bytes);
+		break;
+	case 1:
+		vreg_access(vle8.v, v8, bytes);
+		break;
+	case 2:
+		vreg_access(vle8.v, v16, bytes);
+		break;
+	default:
+		vreg_access(vle8.v, v24, bytes);
+		break;
+	}
+}
+
+static void get_vreg(ulong vlenb, ulong which, ulong pos, ulong size,
+		     u8 *bytes)
+{
+	bytes -= vreg_setup(vlenb, which, pos, size);
+
+	switch (which / 8) {
+	case 0:
+		vreg_access(vse8.v, v0, bytes);
+		break;
+	case 1:
+		vreg_access(vse8.v, v8, bytes);
+		break;
+	case 2:
+		vreg_access(vse8.v, v16, bytes);
+		break;
+	default:
+		vreg_access(vse8.v, v24, bytes);
+		break;
+	}
+}
+
+int sbi_misaligned_v_ldst_emulate(ulong insn, struct sbi_trap_regs *regs)
+{
+	union {
+		u8 bytes[VSEG_MAX_BYTES];
+		ulong words[VSEG_MAX_BYTES / sizeof(ulong)];
+	} data;
+	struct sbi_trap_info uptrap, trap;
+	ulong vl, evl, vtype, vlenb, vstart, vsew, vemul, view;
+	ulong len, nf, emul, stride, base, addr, i, vd;
+	bool store, masked, indexed, fault_first = FALSE;
+	u64 offset;
+	u8 mask = 0;
+
+	if (!IS_VECTOR_LOAD_STORE(insn) || !misa_extension('V'))
+		return SBI_ENOTSUPP;
+
+	store = (insn & INSN_MASK_VECTOR_LOAD_STORE) ==
+		INSN_MATCH_VECTOR_STORE;
+	vl = evl = csr_read(CSR_VL);
+	vtype = csr_read(CSR_VTYPE);
+	vlenb = csr_read(CSR_VLENB);
+	vstart = csr_read(CSR_VSTART);
+	vsew = VTYPE_VSEW(vtype);
+	vd = GET_VD(insn);
+	nf = GET_VNF(insn);
+	masked = GET_VMASKED(insn);
+	indexed = GET_VMOP(insn) == VMOP_INDEXED_UNORDERED ||
+		  GET_VMOP(insn) == VMOP_INDEXED_ORDERED;
+
+	/* log2 of the encoded element (or index) width in bytes */
+	view = GET_VWIDTH(insn);
+	view = (view) ? view - 4 : 0;
+
+	if ((vtype & VTYPE_VILL) || GET_VMEW(insn) ||
+	    vlenb > VLEN_MAX / 8)
+		goto illegal;
+
+	/* Indexed accesses use SEW/LMUL for data and width for indices */
+	if (indexed) {
+		len = 1UL << vsew;
+		vemul = VTYPE_VLMUL(vtype);
+	} else {
+		len = 1UL << view;
+		vemul = (VTYPE_VLMUL(vtype) + view - vsew) & 0x7;
+	}
+	emul = (vemul & 0x4) ? 1 : 1UL << vemul;
+	stride = nf * len;
+
+	switch (GET_VMOP(insn)) {
+	case VMOP_UNIT_STRIDE:
+		switch (GET_VUMOP(insn)) {
+		case VUMOP_UNIT:
+			break;
+		case VUMOP_FAULT_ONLY_FIRST:
+			if (store)
+				goto illegal;
+			fault_first = TRUE;
+			break;
+		case VUMOP_WHOLE_REG:
+			/* The nf registers form one contiguous group */
+			evl = (nf * vlenb) >> view;
+			nf = emul = 1;
+			stride = len;
+			masked = FALSE;
+			break;
+		case VUMOP_MASK:
+			evl = (vl + 7) / 8;
+			nf = emul = len = stride = 1;
+			masked = FALSE;
+			break;
+		default:
+			goto illegal;
+		}
+		break;
+	case VMOP_STRIDED:
+		stride = GET_RS2(insn, regs);
+		break;
+	default:
+		break;
+	}
+
+	if (vd + nf * emul > 32)
+		goto illegal;
+
+	base = GET_RS1(insn, regs);
+	for (; vstart < evl; vstart++) {
+		if (masked) {
+			if (!mask || !(vstart % 8))
+				get_vreg(vlenb, 0, vstart / 8, 1, &mask);
+			if (!((mask >> (vstart % 8)) & 1))
+				continue;
+		}
+
+		if (indexed) {
+			offset = 0;
+			get_vreg(vlenb, GET_VS2(insn), vstart << view,
+				 1UL << view, (u8 *)&offset);
+			addr = base + offset;
+		} else {
+			addr = base + vstart * stride;
+		}
+
+		/* Segment fields of an element are contiguous in memory */
+		if (store) {
+			for (i = 0; i < nf; i++)
+				get_vreg(vlenb, vd + i * emul, vstart * len,
+					 len, &data.bytes[i * len]);
+		}
+
+		for (i = 0; i < nf * len; i += sizeof(ulong)) {
+			if (store)
+				sbi_store_bytes((u8 *)(addr + i), nf * len - i,
+						data.words[i / sizeof(ulong)],
+						&uptrap);
+			else
+				sbi_load_bytes((u8 *)(addr + i), nf * len - i,
+					       &data.words[i / sizeof(ulong)],
+					       &uptrap);
+			if (!uptrap.cause)
+				continue;
+
+			/* Fault-only-first loads trim VL past element 0 */
+			if (fault_first && vstart) {
+				vl = evl = vstart;
+				goto done;
+			}
+
+			vsetvl(vl, vtype);
+			csr_write(CSR_VSTART, vstart);
+			uptrap.epc = regs->mepc;
+			if (uptrap.tinst != INSN_PSEUDO_VS_LOAD &&
+			    uptrap.tinst != INSN_PSEUDO_VS_STORE)
+				uptrap.tinst = 0;
+			return sbi_trap_redirect(regs, &uptrap);
+		}
+
+		if (!store) {
+			for (i = 0; i < nf; i++)
+				set_vreg(vlenb, vd + i * emul, vstart * len,
+					 len, &data.bytes[i * len]);
+		}
+	}
+
+done:
+	/* Restore VL and VTYPE clobbered by register accesses */
+	vsetvl(vl, vtype);
+	regs->mepc += 4;
+
+	return 0;
+
+illegal:
+	trap.epc = regs->mepc;
+	trap.cause = CAUSE_ILLEGAL_INSTRUCTION;
+	trap.tval = insn;
+	trap.tval2 = 0;
+	trap.tinst = 0;
+	trap.gva = 0;
+	return sbi_trap_redirect(regs, &trap);
+}
+
+#endif
@@ -10,9 +10,10 @@
 #include <sbi/riscv_asm.h>
 #include <sbi/sbi_bitops.h>
 #include <sbi/sbi_console.h>
+#include <sbi/sbi_domain.h>
 #include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_hart.h>
-#include <sbi/sbi_hartmask.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_pmu.h>
 #include <sbi/sbi_scratch.h>
@@ -56,17 +57,60 @@ static const struct sbi_pmu_device *pmu_dev = NULL;
 /* Mapping between event range and possible counters  */
 static struct sbi_pmu_hw_event hw_event_map[SBI_PMU_HW_EVENT_MAX] = {0};
 
-/* counter to enabled event mapping */
-static uint32_t active_events[SBI_HARTMASK_MAX_BITS][SBI_PMU_HW_CTR_MAX + SBI_PMU_FW_CTR_MAX];
-
-/* Bitmap of firmware counters started on each HART */
 #if SBI_PMU_FW_CTR_MAX >= BITS_PER_LONG
 #error "Can't handle firmware counters beyond BITS_PER_LONG"
 #endif
-static unsigned long fw_counters_started[SBI_HARTMASK_MAX_BITS];
 
-/* Values of firmwares counters on each HART */
-static uint64_t fw_counters_value[SBI_HARTMASK_MAX_BITS][SBI_PMU_FW_CTR_MAX] = {0};
+#if SBI_PMU_FW_CTR_MAX > 16
+#error "Can't handle firmware counters beyond 16"
+#endif
+
+/* Size and alignment of the snapshot shared memory */
+#define PMU_SNAPSHOT_SIZE	4096
+
+/** Layout of the snapshot shared memory as per SBI specification */
+struct sbi_pmu_snapshot {
+	/* Bitmap of overflown counters relative to counter index base */
+	uint64_t counter_overflow_bitmap;
+	/* Values of all logical counters indexed by counter index */
+	uint64_t counter_values[64];
+	uint64_t reserved[447];
+};
+
+/* Cache line size used to align the per-HART PMU state */
+#define PMU_HART_STATE_ALIGN	64
+
+/** Per-HART PMU state */
+struct sbi_pmu_hart_state {
+	/* Counter to enabled event mapping */
+	uint32_t active_events[SBI_PMU_HW_CTR_MAX + SBI_PMU_FW_CTR_MAX];
+	/* Bitmap of firmware counters started */
+	unsigned long fw_counters_started;
+	/* Values of firmwares counters */
+	uint64_t fw_counters_value[SBI_PMU_FW_CTR_MAX];
+	/* Bitmap of started firmware counters for each firmware event */
+	uint16_t fw_event_counters[SBI_PMU_FW_MAX];
+	/* Bitmap of overflown counters indexed by counter index */
+	uint64_t ctr_overflow_mask;
+	/* Snapshot shared memory registered by supervisor (or NULL) */
+	struct sbi_pmu_snapshot *snapshot;
+};
+
+_Static_assert(sizeof(struct sbi_pmu_snapshot) == PMU_SNAPSHOT_SIZE,
+	       "PMU snapshot layout does not match the SBI specification");
+
+/* Offset of pointer to cache line aligned PMU state in scratch space */
+static unsigned long phs_ptr_offset;
+
+/* Offset of memory backing the PMU state in scratch space */
+static unsigned long phs_mem_offset;
+
+#define pmu_get_hart_state_ptr(__scratch)				\
+	(*((struct sbi_pmu_hart_state **)				\
+	   sbi_scratch_offset_ptr((__scratch), phs_ptr_offset)))
+
+#define pmu_thishart_state_ptr()					\
+	pmu_get_hart_state_ptr(sbi_scratch_thishart_ptr())
 
 /* Maximum number of hardware events available */
 static uint32_t num_hw_events;
@@ -157,12 +201,12 @@ static int pmu_ctr_validate(uint32_t cidx, uint32_t *event_idx_code)
 {
 	uint32_t event_idx_val;
 	uint32_t event_idx_type;
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
 
 	if (cidx >= total_ctrs)
 		return SBI_EINVAL;
 
-	event_idx_val = active_events[hartid][cidx];
+	event_idx_val = phs->active_events[cidx];
 	event_idx_type = get_cidx_type(event_idx_val);
 	if (event_idx_val == SBI_PMU_EVENT_IDX_INVALID ||
 	    event_idx_type >= SBI_PMU_EVENT_TYPE_MAX)
@@ -173,22 +217,27 @@ static int pmu_ctr_validate(uint32_t cidx, uint32_t *event_idx_code)
 	return event_idx_type;
 }
 
+static uint64_t pmu_ctr_read_fw(struct sbi_pmu_hart_state *phs,
+			       uint32_t cidx, uint32_t event_code)
+{
+	if (SBI_PMU_FW_MAX <= event_code &&
+	    pmu_dev && pmu_dev->fw_counter_read_value)
+		phs->fw_counters_value[cidx - num_hw_ctrs] =
+			pmu_dev->fw_counter_read_value(cidx - num_hw_ctrs);
+
+	return phs->fw_counters_value[cidx - num_hw_ctrs];
+}
+
 int sbi_pmu_ctr_fw_read(uint32_t cidx, uint64_t *cval)
 {
 	int event_idx_type;
 	uint32_t event_code;
-	u32 hartid = current_hartid();
 
 	event_idx_type = pmu_ctr_validate(cidx, &event_code);
 	if (event_idx_type != SBI_PMU_EVENT_TYPE_FW)
 		return SBI_EINVAL;
 
-	if (SBI_PMU_FW_MAX <= event_code &&
-	    pmu_dev && pmu_dev->fw_counter_read_value)
-		fw_counters_value[hartid][cidx - num_hw_ctrs] =
-			pmu_dev->fw_counter_read_value(cidx - num_hw_ctrs);
-
-	*cval = fw_counters_value[hartid][cidx - num_hw_ctrs];
+	*cval = pmu_ctr_read_fw(pmu_thishart_state_ptr(), cidx, event_code);
 
 	return 0;
 }
@@ -309,6 +358,38 @@ static void pmu_ctr_write_hw(uint32_t cidx, uint64_t ival)
 #endif
 }
 
+static uint64_t pmu_ctr_read_hw(uint32_t cidx)
+{
+#if __riscv_xlen == 32
+	uint32_t lo, hi;
+
+	do {
+		hi = csr_read_num(CSR_MCYCLEH + cidx);
+		lo = csr_read_num(CSR_MCYCLE + cidx);
+	} while (hi != csr_read_num(CSR_MCYCLEH + cidx));
+
+	return ((uint64_t)hi << 32) | lo;
+#else
+	return csr_read_num(CSR_MCYCLE + cidx);
+#endif
+}
+
+static bool pmu_ctr_overflowed_hw(uint32_t cidx)
+{
+	if (cidx < 3 || cidx >= num_hw_ctrs ||
+	    !sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
+				    SBI_HART_EXT_SSCOFPMF))
+		return FALSE;
+
+#if __riscv_xlen == 32
+	return (csr_read_num(CSR_MHPMEVENT3H + cidx - 3) & MHPMEVENTH_OF) ?
+		TRUE : FALSE;
+#else
+	return (csr_read_num(CSR_MHPMEVENT3 + cidx - 3) & MHPMEVENT_OF) ?
+		TRUE : FALSE;
+#endif
+}
+
 static int pmu_ctr_start_hw(uint32_t cidx, uint64_t ival, bool ival_update)
 {
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
@@ -356,11 +437,27 @@ int sbi_pmu_irq_bit(void)
 	return 0;
 }
 
+static void pmu_ctr_mark_fw(struct sbi_pmu_hart_state *phs, uint32_t cidx, uint32_t event_code,
+			    bool started)
+{
+	uint32_t fw_cidx = cidx - num_hw_ctrs;
+
+	if (started) {
+		phs->fw_counters_started |= BIT(fw_cidx);
+		if (event_code < SBI_PMU_FW_MAX)
+			phs->fw_event_counters[event_code] |= BIT(fw_cidx);
+	} else {
+		phs->fw_counters_started &= ~BIT(fw_cidx);
+		if (event_code < SBI_PMU_FW_MAX)
+			phs->fw_event_counters[event_code] &= ~BIT(fw_cidx);
+	}
+}
+
 static int pmu_ctr_start_fw(uint32_t cidx, uint32_t event_code,
 			    uint64_t ival, bool ival_update)
 {
 	int ret;
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
 
 	if (SBI_PMU_FW_MAX <= event_code &&
 	    pmu_dev && pmu_dev->fw_counter_start) {
@@ -372,8 +469,8 @@ static int pmu_ctr_start_fw(uint32_t cidx, uint32_t event_code,
 	}
 
 	if (ival_update)
-		fw_counters_value[hartid][cidx - num_hw_ctrs] = ival;
-	fw_counters_started[hartid] |= BIT(cidx - num_hw_ctrs);
+		phs->fw_counters_value[cidx - num_hw_ctrs] = ival;
+	pmu_ctr_mark_fw(phs, cidx, event_code, true);
 
 	return 0;
 }
@@ -381,6 +478,8 @@ static int pmu_ctr_start_fw(uint32_t cidx, uint32_t event_code,
 int sbi_pmu_ctr_start(unsigned long cbase, unsigned long cmask,
 		      unsigned long flags, uint64_t ival)
 {
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
+	struct sbi_pmu_snapshot *snap = phs->snapshot;
 	int event_idx_type;
 	uint32_t event_code;
 	int ret = SBI_EINVAL;
@@ -390,7 +489,11 @@ int sbi_pmu_ctr_start(unsigned long cbase, unsigned long cmask,
 	if ((cbase + sbi_fls(cmask)) >= total_ctrs)
 		return ret;
 
-	if (flags & SBI_PMU_START_FLAG_SET_INIT_VALUE)
+	if (flags & SBI_PMU_START_FLAG_INIT_SNAPSHOT) {
+		if (!snap)
+			return SBI_ENO_SHMEM;
+		bUpdate = TRUE;
+	} else if (flags & SBI_PMU_START_FLAG_SET_INIT_VALUE)
 		bUpdate = TRUE;
 
 	for_each_set_bit(i, &cmask, total_ctrs) {
@@ -399,12 +502,25 @@ int sbi_pmu_ctr_start(unsigned long cbase, unsigned long cmask,
 		if (event_idx_type < 0)
 			/* Continue the start operation for other counters */
 			continue;
-		else if (event_idx_type == SBI_PMU_EVENT_TYPE_FW)
+
+		/* Snapshot values are indexed relative to cbase */
+		if (flags & SBI_PMU_START_FLAG_INIT_SNAPSHOT)
+			ival = snap->counter_values[i];
+
+		if (event_idx_type == SBI_PMU_EVENT_TYPE_FW)
 			ret = pmu_ctr_start_fw(cidx, event_code, ival, bUpdate);
 		else
 			ret = pmu_ctr_start_hw(cidx, ival, bUpdate);
+
+		/* A restarted counter begins without pending overflow */
+		if (!ret)
+			phs->ctr_overflow_mask &= ~(1ULL << cidx);
 	}
 
+	if (flags & SBI_PMU_START_FLAG_INIT_SNAPSHOT)
+		snap->counter_overflow_bitmap =
+			(phs->ctr_overflow_mask >> cbase) & cmask;
+
 	return ret;
 }
 
@@ -441,7 +557,7 @@ static int pmu_ctr_stop_fw(uint32_t cidx, uint32_t event_code)
 			return ret;
 	}
 
-	fw_counters_started[current_hartid()] &= ~BIT(cidx - num_hw_ctrs);
+	pmu_ctr_mark_fw(pmu_thishart_state_ptr(), cidx, event_code, false);
 
 	return 0;
 }
@@ -465,7 +581,10 @@ static int pmu_reset_hw_mhpmevent(int ctr_idx)
 int sbi_pmu_ctr_stop(unsigned long cbase, unsigned long cmask,
 		     unsigned long flag)
 {
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
+	struct sbi_pmu_snapshot *snap = phs->snapshot;
+	bool take_snapshot = (flag & SBI_PMU_STOP_FLAG_TAKE_SNAPSHOT) ?
+			     TRUE : FALSE;
 	int ret = SBI_EINVAL;
 	int event_idx_type;
 	uint32_t event_code;
@@ -474,6 +593,9 @@ int sbi_pmu_ctr_stop(unsigned long cbase, unsigned long cmask,
 	if ((cbase + sbi_fls(cmask)) >= total_ctrs)
 		return SBI_EINVAL;
 
+	if (take_snapshot && !snap)
+		return SBI_ENO_SHMEM;
+
 	for_each_set_bit(i, &cmask, total_ctrs) {
 		cidx = i + cbase;
 		event_idx_type = pmu_ctr_validate(cidx, &event_code);
@@ -483,18 +605,62 @@ int sbi_pmu_ctr_stop(unsigned long cbase, unsigned long cmask,
 
 		else if (event_idx_type == SBI_PMU_EVENT_TYPE_FW)
 			ret = pmu_ctr_stop_fw(cidx, event_code);
-		else
+		else {
 			ret = pmu_ctr_stop_hw(cidx);
+			if (!ret && pmu_ctr_overflowed_hw(cidx))
+				phs->ctr_overflow_mask |= 1ULL << cidx;
+		}
+
+		if (take_snapshot &&
+		    (!ret || ret == SBI_EALREADY_STOPPED))
+			snap->counter_values[i] =
+				(event_idx_type == SBI_PMU_EVENT_TYPE_FW) ?
+				pmu_ctr_read_fw(phs, cidx, event_code) :
+				pmu_ctr_read_hw(cidx);
 
 		if (flag & SBI_PMU_STOP_FLAG_RESET) {
-			active_events[hartid][cidx] = SBI_PMU_EVENT_IDX_INVALID;
+			phs->active_events[cidx] = SBI_PMU_EVENT_IDX_INVALID;
 			pmu_reset_hw_mhpmevent(cidx);
 		}
 	}
 
+	if (take_snapshot)
+		snap->counter_overflow_bitmap =
+			(phs->ctr_overflow_mask >> cbase) & cmask;
+
 	return ret;
 }
 
+int sbi_pmu_snapshot_set_shmem(unsigned long shmem_lo,
+			       unsigned long shmem_hi,
+			       unsigned long flags)
+{
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
+
+	if (flags)
+		return SBI_EINVAL;
+
+	/* All-ones address disables the snapshot shared memory */
+	if (shmem_lo == -1UL && shmem_hi == -1UL) {
+		phs->snapshot = NULL;
+		return 0;
+	}
+
+	if (shmem_lo & (PMU_SNAPSHOT_SIZE - 1))
+		return SBI_EINVAL;
+
+	/* Only shared memory addressable by M-mode is supported */
+	if (shmem_hi ||
+	    !sbi_domain_check_addr_range(sbi_domain_thishart_ptr(), shmem_lo,
+					 PMU_SNAPSHOT_SIZE, PRV_S,
+					 SBI_DOMAIN_READ | SBI_DOMAIN_WRITE))
+		return SBI_EINVALID_ADDR;
+
+	phs->snapshot = (struct sbi_pmu_snapshot *)shmem_lo;
+
+	return 0;
+}
+
 static void pmu_update_inhibit_flags(unsigned long flags, uint64_t *mhpmevent_val)
 {
 	if (flags & SBI_PMU_CFG_FLAG_SET_VUINH)
@@ -565,7 +731,7 @@ static int pmu_ctr_find_hw(unsigned long cbase, unsigned long cmask, unsigned lo
 	int i, ret = 0, fixed_ctr, ctr_idx = SBI_ENOTSUPP;
 	struct sbi_pmu_hw_event *temp;
 	unsigned long mctr_inhbt = 0;
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
 	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
 
 	if (cbase >= num_hw_ctrs)
@@ -604,7 +770,7 @@ static int pmu_ctr_find_hw(unsigned long cbase, unsigned long cmask, unsigned lo
 			 * Some of the platform may not support mcountinhibit.
 			 * Checking the active_events is enough for them
 			 */
-			if (active_events[hartid][cbase] != SBI_PMU_EVENT_IDX_INVALID)
+			if (phs->active_events[cbase] != SBI_PMU_EVENT_IDX_INVALID)
 				continue;
 			/* If mcountinhibit is supported, the bit must be enabled */
 			if ((sbi_hart_priv_version(scratch) >= SBI_HART_PRIV_VER_1_11) &&
@@ -640,7 +806,8 @@ static int pmu_ctr_find_hw(unsigned long cbase, unsigned long cmask, unsigned lo
  * check.
  */
 static int pmu_ctr_find_fw(unsigned long cbase, unsigned long cmask,
-			   uint32_t event_code, u32 hartid)
+			   uint32_t event_code,
+			   struct sbi_pmu_hart_state *phs)
 {
 	int i, cidx;
 
@@ -648,7 +815,7 @@ static int pmu_ctr_find_fw(unsigned long cbase, unsigned long cmask,
 		cidx = i + cbase;
 		if (cidx < num_hw_ctrs || total_ctrs <= cidx)
 			continue;
-		if (active_events[hartid][i] != SBI_PMU_EVENT_IDX_INVALID)
+		if (phs->active_events[i] != SBI_PMU_EVENT_IDX_INVALID)
 			continue;
 		if (SBI_PMU_FW_MAX <= event_code &&
 		    pmu_dev && pmu_dev->fw_counter_match_code) {
@@ -668,7 +835,8 @@ int sbi_pmu_ctr_cfg_match(unsigned long cidx_base, unsigned long cidx_mask,
 			  uint64_t event_data)
 {
 	int ret, ctr_idx = SBI_ENOTSUPP;
-	u32 event_code, hartid = current_hartid();
+	u32 event_code;
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
 	int event_type;
 
 	/* Do a basic sanity check of counter base & mask */
@@ -685,15 +853,22 @@ int sbi_pmu_ctr_cfg_match(unsigned long cidx_base, unsigned long cidx_mask,
 		 * counter idx for the given event. Verify that the counter idx
 		 * is still valid.
 		 */
-		if (active_events[hartid][cidx_base] == SBI_PMU_EVENT_IDX_INVALID)
+		if (phs->active_events[cidx_base] == SBI_PMU_EVENT_IDX_INVALID)
 			return SBI_EINVAL;
 		ctr_idx = cidx_base;
+		/*
+		 * The counter keeps its configured event so use that one,
+		 * otherwise stopping the counter won't find its binding.
+		 */
+		event_type = pmu_ctr_validate(ctr_idx, &event_code);
+		if (event_type < 0)
+			return SBI_EINVAL;
 		goto skip_match;
 	}
 
 	if (event_type == SBI_PMU_EVENT_TYPE_FW) {
 		/* Any firmware counter can be used track any firmware event */
-		ctr_idx = pmu_ctr_find_fw(cidx_base, cidx_mask, event_code, hartid);
+		ctr_idx = pmu_ctr_find_fw(cidx_base, cidx_mask, event_code, phs);
 	} else {
 		ctr_idx = pmu_ctr_find_hw(cidx_base, cidx_mask, flags, event_idx,
 					  event_data);
@@ -702,7 +877,7 @@ int sbi_pmu_ctr_cfg_match(unsigned long cidx_base, unsigned long cidx_mask,
 	if (ctr_idx < 0)
 		return SBI_ENOTSUPP;
 
-	active_events[hartid][ctr_idx] = event_idx;
+	phs->active_events[ctr_idx] = event_idx;
 skip_match:
 	if (event_type == SBI_PMU_EVENT_TYPE_HW) {
 		if (flags & SBI_PMU_CFG_FLAG_CLEAR_VALUE)
@@ -711,18 +886,18 @@ skip_match:
 			pmu_ctr_start_hw(ctr_idx, 0, false);
 	} else if (event_type == SBI_PMU_EVENT_TYPE_FW) {
 		if (flags & SBI_PMU_CFG_FLAG_CLEAR_VALUE)
-			fw_counters_value[hartid][ctr_idx - num_hw_ctrs] = 0;
+			phs->fw_counters_value[ctr_idx - num_hw_ctrs] = 0;
 		if (flags & SBI_PMU_CFG_FLAG_AUTO_START) {
 			if (SBI_PMU_FW_MAX <= event_code &&
 			    pmu_dev && pmu_dev->fw_counter_start) {
 				ret = pmu_dev->fw_counter_start(
 					ctr_idx - num_hw_ctrs, event_code,
-					fw_counters_value[hartid][ctr_idx - num_hw_ctrs],
+					phs->fw_counters_value[ctr_idx - num_hw_ctrs],
 					true);
 				if (ret)
 					return ret;
 			}
-			fw_counters_started[hartid] |= BIT(ctr_idx - num_hw_ctrs);
+			pmu_ctr_mark_fw(phs, ctr_idx, event_code, true);
 		}
 	}
 
@@ -731,26 +906,23 @@ skip_match:
 
 int sbi_pmu_ctr_incr_fw(enum sbi_pmu_fw_event_code_id fw_id)
 {
-	u32 cidx, hartid = current_hartid();
-	uint64_t *fcounter = NULL;
+	struct sbi_pmu_hart_state *phs = pmu_thishart_state_ptr();
+	unsigned long fw_ctrs;
 
-	if (likely(!fw_counters_started[hartid]))
+	if (likely(!phs->fw_counters_started))
 		return 0;
 
 	if (unlikely(fw_id >= SBI_PMU_FW_MAX))
 		return SBI_EINVAL;
 
-	for (cidx = num_hw_ctrs; cidx < total_ctrs; cidx++) {
-		if (get_cidx_code(active_events[hartid][cidx]) == fw_id &&
-		    (fw_counters_started[hartid] & BIT(cidx - num_hw_ctrs))) {
-			fcounter = &fw_counters_value[hartid][cidx - num_hw_ctrs];
-			break;
-		}
+	/* Increment the first started counter bound to this event */
+	fw_ctrs = phs->fw_event_counters[fw_id];
+	if (fw_ctrs) {
+		fw_ctrs = sbi_ffs(fw_ctrs);
+		if (unlikely(!++phs->fw_counters_value[fw_ctrs]))
+			phs->ctr_overflow_mask |= 1ULL << (num_hw_ctrs + fw_ctrs);
 	}
 
-	if (fcounter)
-		(*fcounter)++;
-
 	return 0;
 }
 
@@ -789,16 +961,19 @@ int sbi_pmu_ctr_get_info(uint32_t cidx, unsigned long *ctr_info)
 	return 0;
 }
 
-static void pmu_reset_event_map(u32 hartid)
+static void pmu_reset_event_map(struct sbi_pmu_hart_state *phs)
 {
 	int j;
 
 	/* Initialize the counter to event mapping table */
 	for (j = 3; j < total_ctrs; j++)
-		active_events[hartid][j] = SBI_PMU_EVENT_IDX_INVALID;
+		phs->active_events[j] = SBI_PMU_EVENT_IDX_INVALID;
 	for (j = 0; j < SBI_PMU_FW_CTR_MAX; j++)
-		fw_counters_value[hartid][j] = 0;
-	fw_counters_started[hartid] = 0;
+		phs->fw_counters_value[j] = 0;
+	phs->fw_counters_started = 0;
+	for (j = 0; j < SBI_PMU_FW_MAX; j++)
+		phs->fw_event_counters[j] = 0;
+	phs->ctr_overflow_mask = 0;
 }
 
 const struct sbi_pmu_device *sbi_pmu_get_device(void)
@@ -816,22 +991,33 @@ void sbi_pmu_set_device(const struct sbi_pmu_device *dev)
 
 void sbi_pmu_exit(struct sbi_scratch *scratch)
 {
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs = pmu_get_hart_state_ptr(scratch);
 
 	if (sbi_hart_priv_version(scratch) >= SBI_HART_PRIV_VER_1_11)
 		csr_write(CSR_MCOUNTINHIBIT, 0xFFFFFFF8);
 
 	if (sbi_hart_priv_version(scratch) >= SBI_HART_PRIV_VER_1_10)
 		csr_write(CSR_MCOUNTEREN, -1);
-	pmu_reset_event_map(hartid);
+	pmu_reset_event_map(phs);
+	phs->snapshot = NULL;
 }
 
 int sbi_pmu_init(struct sbi_scratch *scratch, bool cold_boot)
 {
 	const struct sbi_platform *plat;
-	u32 hartid = current_hartid();
+	struct sbi_pmu_hart_state *phs;
+	unsigned long phs_mem;
 
 	if (cold_boot) {
+		phs_ptr_offset = sbi_scratch_alloc_offset(sizeof(phs));
+		if (!phs_ptr_offset)
+			return SBI_ENOMEM;
+
+		phs_mem_offset = sbi_scratch_alloc_offset(sizeof(*phs) +
+							  PMU_HART_STATE_ALIGN);
+		if (!phs_mem_offset)
+			return SBI_ENOMEM;
+
 		plat = sbi_platform_ptr(scratch);
 		/* Initialize hw pmu events */
 		sbi_platform_pmu_init(plat);
@@ -839,16 +1025,27 @@ int sbi_pmu_init(struct sbi_scratch *scratch, bool cold_boot)
 		/* mcycle & minstret is available always */
 		num_hw_ctrs = sbi_hart_mhpm_count(scratch) + 3;
 		total_ctrs = num_hw_ctrs + SBI_PMU_FW_CTR_MAX;
+	} else {
+		if (!phs_ptr_offset || !phs_mem_offset)
+			return SBI_ENOMEM;
 	}
 
-	pmu_reset_event_map(hartid);
+	/* Place the PMU state on its own cache lines */
+	phs_mem = (unsigned long)sbi_scratch_offset_ptr(scratch, phs_mem_offset);
+	phs_mem = (phs_mem + PMU_HART_STATE_ALIGN - 1) &
+		  ~(PMU_HART_STATE_ALIGN - 1UL);
+	phs = (struct sbi_pmu_hart_state *)phs_mem;
+	pmu_get_hart_state_ptr(scratch) = phs;
+
+	pmu_reset_event_map(phs);
+	phs->snapshot = NULL;
 
 	/* First three counters are fixed by the priv spec and we enable it by default */
-	active_events[hartid][0] = SBI_PMU_EVENT_TYPE_HW << SBI_PMU_EVENT_IDX_OFFSET |
-				   SBI_PMU_HW_CPU_CYCLES;
-	active_events[hartid][1] = SBI_PMU_EVENT_IDX_INVALID;
-	active_events[hartid][2] = SBI_PMU_EVENT_TYPE_HW << SBI_PMU_EVENT_IDX_OFFSET |
-				   SBI_PMU_HW_INSTRUCTIONS;
+	phs->active_events[0] = SBI_PMU_EVENT_TYPE_HW << SBI_PMU_EVENT_IDX_OFFSET |
+				SBI_PMU_HW_CPU_CYCLES;
+	phs->active_events[1] = SBI_PMU_EVENT_IDX_INVALID;
+	phs->active_events[2] = SBI_PMU_EVENT_TYPE_HW << SBI_PMU_EVENT_IDX_OFFSET |
+				SBI_PMU_HW_INSTRUCTIONS;
 
 	return 0;
 }
@@ -0,0 +1,150 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_atomic.h>
+#include <sbi/riscv_barrier.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_ring.h>
+#include <sbi/sbi_string.h>
+
+/*
+ * Each slot has a sequence word which tells the state of slot for a
+ * given ring position "pos":
+ * seq == pos                   : Slot is free for position "pos"
+ * seq == pos + 1               : Slot holds a published entry
+ * seq == pos (after publish)   : Slot is claimed by the consumer or by
+ *                                a producer doing in-place update
+ * seq == pos + num_entries     : Slot is free for the next round
+ */
+
+static inline void *ring_slot(struct sbi_ring *ring, unsigned long pos)
+{
+	return (char *)ring->queue +
+		(pos & (ring->num_entries - 1)) *
+		SBI_RING_SLOT_SIZE(ring->entry_size);
+}
+
+static inline volatile unsigned long *ring_slot_seq(void *slot)
+{
+	return slot;
+}
+
+static inline void *ring_slot_data(void *slot)
+{
+	return (char *)slot + __SIZEOF_POINTER__;
+}
+
+int sbi_ring_init(struct sbi_ring *ring, void *queue_mem, u16 entries,
+		  u16 entry_size)
+{
+	u16 i;
+
+	if (!ring || !queue_mem || !entries || (entries & (entries - 1)))
+		return SBI_EINVAL;
+
+	ring->queue	  = queue_mem;
+	ring->num_entries = entries;
+	ring->entry_size  = entry_size;
+	ring->head = ring->tail = 0;
+	sbi_memset(ring->queue, 0, SBI_RING_MEM_SIZE(entries, entry_size));
+	for (i = 0; i < entries; i++)
+		*ring_slot_seq(ring_slot(ring, i)) = i;
+	smp_wmb();
+
+	return 0;
+}
+
+int sbi_ring_enqueue(struct sbi_ring *ring, void *data)
+{
+	void *slot;
+	unsigned long pos, seq;
+
+	if (!ring || !data)
+		return SBI_EINVAL;
+
+	while (1) {
+		pos = ring->head;
+		slot = ring_slot(ring, pos);
+		seq = __smp_load_acquire(ring_slot_seq(slot));
+		if (seq == pos) {
+			if (atomic_raw_cmpxchg_ulong(&ring->head,
+						     pos, pos + 1) == pos)
+				break;
+		} else if ((long)(seq - pos) < 0) {
+			return SBI_ENOSPC;
+		}
+	}
+
+	sbi_memcpy(ring_slot_data(slot), data, ring->entry_size);
+	__smp_store_release(ring_slot_seq(slot), pos + 1);
+
+	return 0;
+}
+
+/* Note: must be called only from the HART owning the ring */
+int sbi_ring_dequeue(struct sbi_ring *ring, void *data)
+{
+	void *slot;
+	unsigned long pos;
+
+	if (!ring || !data)
+		return SBI_EINVAL;
+
+	pos = ring->tail;
+	slot = ring_slot(ring, pos);
+
+	/*
+	 * Claim the slot so that producers can't update it in-place
+	 * while we are copying it out. If a producer is updating the
+	 * slot right now then report an empty ring because the producer
+	 * will trigger IPI again after the update.
+	 */
+	if (atomic_raw_cmpxchg_ulong(ring_slot_seq(slot),
+				     pos + 1, pos) != pos + 1)
+		return SBI_ENOENT;
+
+	sbi_memcpy(data, ring_slot_data(slot), ring->entry_size);
+
+	ring->tail = pos + 1;
+	__smp_store_release(ring_slot_seq(slot), pos + ring->num_entries);
+
+	return 0;
+}
+
+/**
+ * Provide a helper function to do inplace update to the ring.
+ * Note: The callback function is called with the ring slot claimed so
+ * the consumer will not dequeue the slot until the callback returns.
+ *
+ * **Do not** invoke any other ring function from callback.
+ */
+int sbi_ring_inplace_update(struct sbi_ring *ring, void *in,
+			    int (*fptr)(void *in, void *data))
+{
+	void *slot;
+	unsigned long pos, head;
+	int ret = SBI_RING_UNCHANGED;
+
+	if (!ring || !in)
+		return ret;
+
+	pos = ring->tail;
+	head = ring->head;
+	for (; (long)(head - pos) > 0; pos++) {
+		slot = ring_slot(ring, pos);
+		if (atomic_raw_cmpxchg_ulong(ring_slot_seq(slot),
+					     pos + 1, pos) != pos + 1)
+			continue;
+
+		ret = fptr(in, ring_slot_data(slot));
+		__smp_store_release(ring_slot_seq(slot), pos + 1);
+
+		if (ret == SBI_RING_SKIP || ret == SBI_RING_UPDATED)
+			break;
+	}
+
+	return ret;
+}
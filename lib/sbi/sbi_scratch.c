@@ -17,7 +17,7 @@
 u32 last_hartid_having_scratch = SBI_HARTMASK_MAX_BITS - 1;
 struct sbi_scratch *hartid_to_scratch_table[SBI_HARTMASK_MAX_BITS] = { 0 };
 
-static spinlock_t extra_lock = SPIN_LOCK_INITIALIZER;
+static qspinlock_t extra_lock = QSPIN_LOCK_INITIALIZER;
 static unsigned long extra_offset = SBI_SCRATCH_EXTRA_SPACE_OFFSET;
 
 typedef struct sbi_scratch *(*hartid2scratch)(ulong hartid, ulong hartindex);
@@ -62,7 +62,7 @@ unsigned long sbi_scratch_alloc_offset(unsigned long size)
 	if (size & (__SIZEOF_POINTER__ - 1))
 		size = (size & ~(__SIZEOF_POINTER__ - 1)) + __SIZEOF_POINTER__;
 
-	spin_lock(&extra_lock);
+	qspin_lock(&extra_lock);
 
 	if (SBI_SCRATCH_SIZE < (extra_offset + size))
 		goto done;
@@ -71,7 +71,7 @@ unsigned long sbi_scratch_alloc_offset(unsigned long size)
 	extra_offset += size;
 
 done:
-	spin_unlock(&extra_lock);
+	qspin_unlock(&extra_lock);
 
 	if (ret) {
 		for (i = 0; i <= sbi_scratch_last_hartid(); i++) {
@@ -8,8 +8,9 @@
  */
 
 /*
- * Simple libc functions. These are not optimized at all and might have some
- * bugs as well. Use any optimized routines from newlib or glibc if required.
+ * Simple libc functions. Only the memory functions are optimized to use
+ * word-sized accesses. Use any optimized routines from newlib or glibc if
+ * required.
  */
 
 #include <sbi/sbi_string.h>
@@ -109,9 +110,102 @@ char *sbi_strrchr(const char *s, int c)
 	else
 		return (char *)last;
 }
-void *sbi_memset(void *s, int c, size_t count)
+/*
+ * The memory functions below work on naturally aligned XLEN words
+ * whenever source and destination have the same alignment. GCC may
+ * turn the word loops back into memset()/memcpy() calls which are
+ * mapped to these very functions so prevent that explicitly.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#define __no_loop_patterns \
+	__attribute__((optimize("no-tree-loop-distribute-patterns")))
+#else
+#define __no_loop_patterns
+#endif
+
+#define WORD_SIZE		sizeof(unsigned long)
+#define WORD_MASK		(WORD_SIZE - 1)
+#define WORD_UNROLL_SIZE	(4 * WORD_SIZE)
+
+static inline bool words_aligned(const void *a, const void *b)
+{
+	return !(((unsigned long)a ^ (unsigned long)b) & WORD_MASK);
+}
+
+static void __no_loop_patterns copy_words_fwd(unsigned long *d,
+					      const unsigned long *s,
+					      size_t nwords)
+{
+	unsigned long t0, t1, t2, t3;
+
+	for (; nwords >= 4; nwords -= 4, d += 4, s += 4) {
+		t0 = s[0];
+		t1 = s[1];
+		t2 = s[2];
+		t3 = s[3];
+		d[0] = t0;
+		d[1] = t1;
+		d[2] = t2;
+		d[3] = t3;
+	}
+
+	while (nwords--)
+		*d++ = *s++;
+}
+
+static void __no_loop_patterns copy_words_bwd(unsigned long *d,
+					      const unsigned long *s,
+					      size_t nwords)
+{
+	unsigned long t0, t1, t2, t3;
+
+	for (; nwords >= 4; nwords -= 4) {
+		d -= 4;
+		s -= 4;
+		t3 = s[3];
+		t2 = s[2];
+		t1 = s[1];
+		t0 = s[0];
+		d[3] = t3;
+		d[2] = t2;
+		d[1] = t1;
+		d[0] = t0;
+	}
+
+	while (nwords--)
+		*--d = *--s;
+}
+
+void * __no_loop_patterns sbi_memset(void *s, int c, size_t count)
 {
 	char *temp = s;
+	unsigned long *wtemp, pattern;
+
+	if (count >= WORD_UNROLL_SIZE) {
+		while ((unsigned long)temp & WORD_MASK) {
+			*temp++ = c;
+			count--;
+		}
+
+		pattern = (unsigned char)c;
+		pattern |= pattern << 8;
+		pattern |= pattern << 16;
+#if __riscv_xlen > 32
+		pattern |= pattern << 32;
+#endif
+
+		wtemp = (unsigned long *)temp;
+		for (; count >= WORD_UNROLL_SIZE; count -= WORD_UNROLL_SIZE) {
+			wtemp[0] = pattern;
+			wtemp[1] = pattern;
+			wtemp[2] = pattern;
+			wtemp[3] = pattern;
+			wtemp += 4;
+		}
+		for (; count >= WORD_SIZE; count -= WORD_SIZE)
+			*wtemp++ = pattern;
+		temp = (char *)wtemp;
+	}
 
 	while (count > 0) {
 		count--;
@@ -121,11 +215,26 @@ void *sbi_memset(void *s, int c, size_t count)
 	return s;
 }
 
-void *sbi_memcpy(void *dest, const void *src, size_t count)
+void * __no_loop_patterns sbi_memcpy(void *dest, const void *src,
+				     size_t count)
 {
 	char *temp1	  = dest;
 	const char *temp2 = src;
 
+	if (count >= WORD_SIZE && words_aligned(temp1, temp2)) {
+		while ((unsigned long)temp1 & WORD_MASK) {
+			*temp1++ = *temp2++;
+			count--;
+		}
+
+		copy_words_fwd((unsigned long *)temp1,
+			       (const unsigned long *)temp2,
+			       count / WORD_SIZE);
+		temp1 += count & ~WORD_MASK;
+		temp2 += count & ~WORD_MASK;
+		count &= WORD_MASK;
+	}
+
 	while (count > 0) {
 		*temp1++ = *temp2++;
 		count--;
@@ -134,7 +243,8 @@ void *sbi_memcpy(void *dest, const void *src, size_t count)
 	return dest;
 }
 
-void *sbi_memmove(void *dest, const void *src, size_t count)
+void * __no_loop_patterns sbi_memmove(void *dest, const void *src,
+				      size_t count)
 {
 	char *temp1	  = (char *)dest;
 	const char *temp2 = (char *)src;
@@ -142,19 +252,29 @@ void *sbi_memmove(void *dest, const void *src, size_t count)
 	if (src == dest)
 		return dest;
 
-	if (dest < src) {
-		while (count > 0) {
-			*temp1++ = *temp2++;
-			count--;
-		}
-	} else {
-		temp1 = (char *)dest + count - 1;
-		temp2 = (char *)src + count - 1;
+	if (dest < src)
+		return sbi_memcpy(dest, src, count);
+
+	temp1 = (char *)dest + count;
+	temp2 = (char *)src + count;
 
-		while (count > 0) {
-			*temp1-- = *temp2--;
+	if (count >= WORD_SIZE && words_aligned(temp1, temp2)) {
+		while ((unsigned long)temp1 & WORD_MASK) {
+			*--temp1 = *--temp2;
 			count--;
 		}
+
+		copy_words_bwd((unsigned long *)temp1,
+			       (const unsigned long *)temp2,
+			       count / WORD_SIZE);
+		temp1 -= count & ~WORD_MASK;
+		temp2 -= count & ~WORD_MASK;
+		count &= WORD_MASK;
+	}
+
+	while (count > 0) {
+		*--temp1 = *--temp2;
+		count--;
 	}
 
 	return dest;
@@ -165,6 +285,25 @@ int sbi_memcmp(const void *s1, const void *s2, size_t count)
 	const char *temp1 = s1;
 	const char *temp2 = s2;
 
+	if (count >= WORD_SIZE && words_aligned(temp1, temp2)) {
+		for (; count > 0 && ((unsigned long)temp1 & WORD_MASK) &&
+		       (*temp1 == *temp2); count--) {
+			temp1++;
+			temp2++;
+		}
+
+		/* Skip equal words, the differing word is compared below */
+		if (!((unsigned long)temp1 & WORD_MASK)) {
+			for (; count >= WORD_SIZE; count -= WORD_SIZE) {
+				if (*(const unsigned long *)temp1 !=
+				    *(const unsigned long *)temp2)
+					break;
+				temp1 += WORD_SIZE;
+				temp2 += WORD_SIZE;
+			}
+		}
+	}
+
 	for (; count > 0 && (*temp1 == *temp2); count--) {
 		temp1++;
 		temp2++;
@@ -10,7 +10,10 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/sbi_bitops.h>
+#include <sbi/sbi_console.h>
 #include <sbi/sbi_domain.h>
+#include <sbi/sbi_ecall_interface.h>
+#include <sbi/sbi_error.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_hsm.h>
 #include <sbi/sbi_platform.h>
@@ -81,6 +84,9 @@ void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason)
 	/* Stop current HART */
 	sbi_hsm_hart_stop(scratch, FALSE);
 
+	/* Make sure buffered console output reaches the device */
+	sbi_console_flush();
+
 	/* Platform specific reset if domain allowed system reset */
 	if (dom->system_reset_allowed) {
 		const struct sbi_system_reset_device *dev =
@@ -92,3 +98,96 @@ void __noreturn sbi_system_reset(u32 reset_type, u32 reset_reason)
 	/* If platform specific reset did not work then do sbi_exit() */
 	sbi_exit(scratch);
 }
+
+static const struct sbi_system_suspend_device *suspend_dev = NULL;
+
+const struct sbi_system_suspend_device *sbi_system_suspend_get_device(void)
+{
+	return suspend_dev;
+}
+
+void sbi_system_suspend_set_device(const struct sbi_system_suspend_device *dev)
+{
+	if (!dev || suspend_dev)
+		return;
+
+	suspend_dev = dev;
+}
+
+bool sbi_system_suspend_supported(u32 sleep_type)
+{
+	if (SBI_SUSP_SLEEP_TYPE_LAST < sleep_type &&
+	    sleep_type < SBI_SUSP_PLATFORM_SLEEP_START)
+		return FALSE;
+
+	return (suspend_dev && suspend_dev->system_suspend_check &&
+		suspend_dev->system_suspend_check(sleep_type)) ? TRUE : FALSE;
+}
+
+int sbi_system_suspend(u32 sleep_type, ulong resume_addr, ulong opaque)
+{
+	int ret;
+	u32 i, hartid = current_hartid();
+	const struct sbi_domain *dom = sbi_domain_thishart_ptr();
+	struct sbi_scratch *scratch = sbi_scratch_thishart_ptr();
+	ulong prev_mode = (csr_read(CSR_MSTATUS) & MSTATUS_MPP) >>
+			  MSTATUS_MPP_SHIFT;
+	void (*jump_warmboot)(void) = (void (*)(void))scratch->warmboot_addr;
+
+	if (!dom || !dom->system_suspend_allowed)
+		return SBI_EFAIL;
+
+	if (!suspend_dev || !suspend_dev->system_suspend)
+		return SBI_EFAIL;
+
+	if (!sbi_system_suspend_supported(sleep_type))
+		return SBI_EINVAL;
+
+	if (prev_mode != PRV_S && prev_mode != PRV_U)
+		return SBI_EFAIL;
+
+	/* All other HARTs of the domain must be stopped */
+	sbi_hartmask_for_each_hart(i, &dom->assigned_harts) {
+		if (i == hartid)
+			continue;
+		if (sbi_hsm_hart_get_state(dom, i) != SBI_HSM_STATE_STOPPED)
+			return SBI_EDENIED;
+	}
+
+	if (!sbi_domain_check_addr(dom, resume_addr, prev_mode,
+				   SBI_DOMAIN_EXECUTE))
+		return SBI_EINVALID_ADDR;
+
+	/* Save the resume address and resume mode */
+	scratch->next_arg1 = opaque;
+	scratch->next_addr = resume_addr;
+	scratch->next_mode = prev_mode;
+
+	/* Resume through the warm boot path like a non-retentive suspend */
+	ret = sbi_hsm_hart_system_suspend_prepare(scratch);
+	if (ret)
+		return ret;
+
+	/* Make sure buffered console output reaches the device */
+	sbi_console_flush();
+
+	ret = suspend_dev->system_suspend(sleep_type, scratch->warmboot_addr);
+	if (ret) {
+		sbi_hsm_hart_system_suspend_cancel(scratch);
+		return ret;
+	}
+
+	/*
+	 * The device has returned after resuming the system so jump to
+	 * the warm boot entry point to simulate a resume at that address.
+	 */
+	jump_warmboot();
+
+	return 0;
+}
+
+void sbi_system_resume(void)
+{
+	if (suspend_dev && suspend_dev->system_resume)
+		suspend_dev->system_resume();
+}
@@ -12,9 +12,10 @@
 #include <sbi/riscv_atomic.h>
 #include <sbi/riscv_barrier.h>
 #include <sbi/sbi_error.h>
-#include <sbi/sbi_fifo.h>
 #include <sbi/sbi_hart.h>
 #include <sbi/sbi_ipi.h>
+#include <sbi/sbi_math.h>
+#include <sbi/sbi_ring.h>
 #include <sbi/sbi_scratch.h>
 #include <sbi/sbi_tlb.h>
 #include <sbi/sbi_hfence.h>
@@ -24,9 +25,11 @@
 #include <sbi/sbi_pmu.h>
 
 static unsigned long tlb_sync_off;
-static unsigned long tlb_fifo_off;
-static unsigned long tlb_fifo_mem_off;
+static unsigned long tlb_pending_off;
+static unsigned long tlb_ring_off;
+static unsigned long tlb_ring_mem_off;
 static unsigned long tlb_range_flush_limit;
+static u16 tlb_ring_num_entries;
 
 static void tlb_flush_all(void)
 {
@@ -215,7 +218,7 @@ static void tlb_entry_process(struct sbi_tlb_info *tinfo)
 {
 	u32 rhartid;
 	struct sbi_scratch *rscratch = NULL;
-	unsigned long *rtlb_sync = NULL;
+	atomic_t *rtlb_sync = NULL;
 
 	tinfo->local_fn(tinfo);
 
@@ -225,7 +228,7 @@ static void tlb_entry_process(struct sbi_tlb_info *tinfo)
 			continue;
 
 		rtlb_sync = sbi_scratch_offset_ptr(rscratch, tlb_sync_off);
-		while (atomic_raw_xchg_ulong(rtlb_sync, 1)) ;
+		atomic_add_return(rtlb_sync, 1);
 	}
 }
 
@@ -233,10 +236,10 @@ static void tlb_process_count(struct sbi_scratch *scratch, int count)
 {
 	struct sbi_tlb_info tinfo;
 	unsigned int deq_count = 0;
-	struct sbi_fifo *tlb_fifo =
-			sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
+	struct sbi_ring *tlb_ring =
+			sbi_scratch_offset_ptr(scratch, tlb_ring_off);
 
-	while (!sbi_fifo_dequeue(tlb_fifo, &tinfo)) {
+	while (!sbi_ring_dequeue(tlb_ring, &tinfo)) {
 		tlb_entry_process(&tinfo);
 		deq_count++;
 		if (deq_count > count)
@@ -248,27 +251,33 @@ static void tlb_process_count(struct sbi_scratch *scratch, int count)
 static void tlb_process(struct sbi_scratch *scratch)
 {
 	struct sbi_tlb_info tinfo;
-	struct sbi_fifo *tlb_fifo =
-			sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
+	struct sbi_ring *tlb_ring =
+			sbi_scratch_offset_ptr(scratch, tlb_ring_off);
 
-	while (!sbi_fifo_dequeue(tlb_fifo, &tinfo))
+	while (!sbi_ring_dequeue(tlb_ring, &tinfo))
 		tlb_entry_process(&tinfo);
 }
 
 static void tlb_sync(struct sbi_scratch *scratch)
 {
-	unsigned long *tlb_sync =
+	atomic_t *tlb_sync =
 			sbi_scratch_offset_ptr(scratch, tlb_sync_off);
+	unsigned long *tlb_pending =
+			sbi_scratch_offset_ptr(scratch, tlb_pending_off);
 
-	while (!atomic_raw_xchg_ulong(tlb_sync, 0)) {
+	if (!*tlb_pending)
+		return;
+
+	while ((unsigned long)atomic_read(tlb_sync) < *tlb_pending) {
 		/*
-		 * While we are waiting for remote hart to set the sync,
-		 * consume fifo requests to avoid deadlock.
+		 * While we are waiting for remote harts to acknowledge,
+		 * consume ring requests to avoid deadlock.
 		 */
 		tlb_process_count(scratch, 1);
 	}
 
-	return;
+	atomic_sub_return(tlb_sync, *tlb_pending);
+	*tlb_pending = 0;
 }
 
 static inline int tlb_range_check(struct sbi_tlb_info *curr,
@@ -276,7 +285,7 @@ static inline int tlb_range_check(struct sbi_tlb_info *curr,
 {
 	unsigned long curr_end;
 	unsigned long next_end;
-	int ret = SBI_FIFO_UNCHANGED;
+	int ret = SBI_RING_UNCHANGED;
 
 	if (!curr || !next)
 		return ret;
@@ -287,30 +296,30 @@ static inline int tlb_range_check(struct sbi_tlb_info *curr,
 		curr->start = next->start;
 		curr->size  = next->size;
 		sbi_hartmask_or(&curr->smask, &curr->smask, &next->smask);
-		ret = SBI_FIFO_UPDATED;
+		ret = SBI_RING_UPDATED;
 	} else if (next->start >= curr->start && next_end <= curr_end) {
 		sbi_hartmask_or(&curr->smask, &curr->smask, &next->smask);
-		ret = SBI_FIFO_SKIP;
+		ret = SBI_RING_SKIP;
 	}
 
 	return ret;
 }
 
 /**
- * Call back to decide if an inplace fifo update is required or next entry can
+ * Call back to decide if an inplace ring update is required or next entry can
  * can be skipped. Here are the different cases that are being handled.
  *
  * Case1:
  *	if next flush request range lies within one of the existing entry, skip
  *	the next entry.
  * Case2:
- *	if flush request range in current fifo entry lies within next flush
+ *	if flush request range in current ring entry lies within next flush
  *	request, update the current entry.
  *
  * Note:
- *	We can not issue a fifo reset anymore if a complete vma flush is requested.
+ *	We can not issue a ring reset anymore if a complete vma flush is requested.
  *	This is because we are queueing FENCE.I requests as well now.
- *	To ease up the pressure in enqueue/fifo sync path, try to dequeue 1 element
+ *	To ease up the pressure in enqueue/ring sync path, try to dequeue 1 element
  *	before continuing the while loop. This method is preferred over wfi/ipi because
  *	of MMIO cost involved in later method.
  */
@@ -318,7 +327,7 @@ static int tlb_update_cb(void *in, void *data)
 {
 	struct sbi_tlb_info *curr;
 	struct sbi_tlb_info *next;
-	int ret = SBI_FIFO_UNCHANGED;
+	int ret = SBI_RING_UNCHANGED;
 
 	if (!in || !data)
 		return ret;
@@ -343,9 +352,11 @@ static int tlb_update(struct sbi_scratch *scratch,
 			  u32 remote_hartid, void *data)
 {
 	int ret;
-	struct sbi_fifo *tlb_fifo_r;
+	struct sbi_ring *tlb_ring_r;
 	struct sbi_tlb_info *tinfo = data;
 	u32 curr_hartid = current_hartid();
+	unsigned long *tlb_pending =
+			sbi_scratch_offset_ptr(scratch, tlb_pending_off);
 
 	/*
 	 * If address range to flush is too big then simply
@@ -366,24 +377,30 @@ static int tlb_update(struct sbi_scratch *scratch,
 		return -1;
 	}
 
-	tlb_fifo_r = sbi_scratch_offset_ptr(remote_scratch, tlb_fifo_off);
+	tlb_ring_r = sbi_scratch_offset_ptr(remote_scratch, tlb_ring_off);
+
+	/*
+	 * The remote hart acknowledges every request (queued or merged)
+	 * once so count the acknowledgements which tlb_sync() waits for.
+	 */
+	(*tlb_pending)++;
 
-	ret = sbi_fifo_inplace_update(tlb_fifo_r, data, tlb_update_cb);
-	if (ret != SBI_FIFO_UNCHANGED) {
+	ret = sbi_ring_inplace_update(tlb_ring_r, data, tlb_update_cb);
+	if (ret != SBI_RING_UNCHANGED) {
 		return 1;
 	}
 
-	while (sbi_fifo_enqueue(tlb_fifo_r, data) < 0) {
+	while (sbi_ring_enqueue(tlb_ring_r, data) < 0) {
 		/**
-		 * For now, Busy loop until there is space in the fifo.
+		 * For now, Busy loop until there is space in the ring.
 		 * There may be case where target hart is also
-		 * enqueue in source hart's fifo. Both hart may busy
+		 * enqueue in source hart's ring. Both hart may busy
 		 * loop leading to a deadlock.
 		 * TODO: Introduce a wait/wakeup event mechanism to handle
 		 * this properly.
 		 */
 		tlb_process_count(scratch, 1);
-		sbi_dprintf("hart%d: hart%d tlb fifo full\n",
+		sbi_dprintf("hart%d: hart%d tlb ring full\n",
 			    curr_hartid, remote_hartid);
 	}
 
@@ -413,30 +430,44 @@ int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 {
 	int ret;
 	void *tlb_mem;
-	unsigned long *tlb_sync;
-	struct sbi_fifo *tlb_q;
+	atomic_t *tlb_sync;
+	unsigned long *tlb_pending;
+	struct sbi_ring *tlb_q;
 	const struct sbi_platform *plat = sbi_platform_ptr(scratch);
 
 	if (cold_boot) {
+		tlb_ring_num_entries = 1UL << log2roundup(
+				sbi_platform_tlb_num_entries(plat));
+		if (!tlb_ring_num_entries)
+			return SBI_EINVAL;
 		tlb_sync_off = sbi_scratch_alloc_offset(sizeof(*tlb_sync));
 		if (!tlb_sync_off)
 			return SBI_ENOMEM;
-		tlb_fifo_off = sbi_scratch_alloc_offset(sizeof(*tlb_q));
-		if (!tlb_fifo_off) {
+		tlb_pending_off = sbi_scratch_alloc_offset(sizeof(*tlb_pending));
+		if (!tlb_pending_off) {
 			sbi_scratch_free_offset(tlb_sync_off);
 			return SBI_ENOMEM;
 		}
-		tlb_fifo_mem_off = sbi_scratch_alloc_offset(
-				SBI_TLB_FIFO_NUM_ENTRIES * SBI_TLB_INFO_SIZE);
-		if (!tlb_fifo_mem_off) {
-			sbi_scratch_free_offset(tlb_fifo_off);
+		tlb_ring_off = sbi_scratch_alloc_offset(sizeof(*tlb_q));
+		if (!tlb_ring_off) {
+			sbi_scratch_free_offset(tlb_pending_off);
+			sbi_scratch_free_offset(tlb_sync_off);
+			return SBI_ENOMEM;
+		}
+		tlb_ring_mem_off = sbi_scratch_alloc_offset(
+				SBI_RING_MEM_SIZE(tlb_ring_num_entries,
+						  SBI_TLB_INFO_SIZE));
+		if (!tlb_ring_mem_off) {
+			sbi_scratch_free_offset(tlb_ring_off);
+			sbi_scratch_free_offset(tlb_pending_off);
 			sbi_scratch_free_offset(tlb_sync_off);
 			return SBI_ENOMEM;
 		}
 		ret = sbi_ipi_event_create(&tlb_ops);
 		if (ret < 0) {
-			sbi_scratch_free_offset(tlb_fifo_mem_off);
-			sbi_scratch_free_offset(tlb_fifo_off);
+			sbi_scratch_free_offset(tlb_ring_mem_off);
+			sbi_scratch_free_offset(tlb_ring_off);
+			sbi_scratch_free_offset(tlb_pending_off);
 			sbi_scratch_free_offset(tlb_sync_off);
 			return ret;
 		}
@@ -444,21 +475,22 @@ int sbi_tlb_init(struct sbi_scratch *scratch, bool cold_boot)
 		tlb_range_flush_limit = sbi_platform_tlbr_flush_limit(plat);
 	} else {
 		if (!tlb_sync_off ||
-		    !tlb_fifo_off ||
-		    !tlb_fifo_mem_off)
+		    !tlb_pending_off ||
+		    !tlb_ring_off ||
+		    !tlb_ring_mem_off)
 			return SBI_ENOMEM;
 		if (SBI_IPI_EVENT_MAX <= tlb_event)
 			return SBI_ENOSPC;
 	}
 
 	tlb_sync = sbi_scratch_offset_ptr(scratch, tlb_sync_off);
-	tlb_q = sbi_scratch_offset_ptr(scratch, tlb_fifo_off);
-	tlb_mem = sbi_scratch_offset_ptr(scratch, tlb_fifo_mem_off);
+	tlb_pending = sbi_scratch_offset_ptr(scratch, tlb_pending_off);
+	tlb_q = sbi_scratch_offset_ptr(scratch, tlb_ring_off);
+	tlb_mem = sbi_scratch_offset_ptr(scratch, tlb_ring_mem_off);
 
-	*tlb_sync = 0;
+	ATOMIC_INIT(tlb_sync, 0);
+	*tlb_pending = 0;
 
-	sbi_fifo_init(tlb_q, tlb_mem,
-		      SBI_TLB_FIFO_NUM_ENTRIES, SBI_TLB_INFO_SIZE);
-
-	return 0;
+	return sbi_ring_init(tlb_q, tlb_mem,
+			     tlb_ring_num_entries, SBI_TLB_INFO_SIZE);
 }
@@ -20,12 +20,15 @@
 #include <sbi/sbi_misaligned_ldst.h>
 #include <sbi/sbi_pmu.h>
 #include <sbi/sbi_scratch.h>
+#include <sbi/sbi_sta.h>
 #include <sbi/sbi_timer.h>
 #include <sbi/sbi_trap.h>
+#include <sbi/sbi_trap_stats.h>
 
 static void __noreturn sbi_trap_error(const char *msg, int rc,
 				      ulong mcause, ulong mtval, ulong mtval2,
-				      ulong mtinst, struct sbi_trap_regs *regs)
+				      ulong mtinst, struct sbi_trap_regs *regs,
+				      bool callee_saved)
 {
 	u32 hartid = current_hartid();
 
@@ -43,8 +46,12 @@ static void __noreturn sbi_trap_error(const char *msg, int rc,
 		   hartid, "ra", regs->ra, "sp", regs->sp);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
 		   hartid, "gp", regs->gp, "tp", regs->tp);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s0", regs->s0, "s1", regs->s1);
+	if (callee_saved)
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s0", regs->s0, "s1", regs->s1);
+	else
+		sbi_printf("%s: hart%d: s0-s11 not saved on the fast path\n",
+			   __func__, hartid);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
 		   hartid, "a0", regs->a0, "a1", regs->a1);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
@@ -53,16 +60,18 @@ static void __noreturn sbi_trap_error(const char *msg, int rc,
 		   hartid, "a4", regs->a4, "a5", regs->a5);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
 		   hartid, "a6", regs->a6, "a7", regs->a7);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s2", regs->s2, "s3", regs->s3);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s4", regs->s4, "s5", regs->s5);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s6", regs->s6, "s7", regs->s7);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s8", regs->s8, "s9", regs->s9);
-	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
-		   hartid, "s10", regs->s10, "s11", regs->s11);
+	if (callee_saved) {
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s2", regs->s2, "s3", regs->s3);
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s4", regs->s4, "s5", regs->s5);
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s6", regs->s6, "s7", regs->s7);
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s8", regs->s8, "s9", regs->s9);
+		sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n",
+			   __func__, hartid, "s10", regs->s10, "s11", regs->s11);
+	}
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
 		   hartid, "t0", regs->t0, "t1", regs->t1);
 	sbi_printf("%s: hart%d: %s=0x%" PRILX " %s=0x%" PRILX "\n", __func__,
@@ -103,7 +112,7 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 	/* If exceptions came from VS/VU-mode, redirect to VS-mode if
 	 * delegated in hedeleg
 	 */
-	if (misa_extension('H') && prev_virt) {
+	if ((sbi_hart_fast_flags() & SBI_HART_FAST_HEXT) && prev_virt) {
 		if ((trap->cause < __riscv_xlen) &&
 		    (csr_read(CSR_HEDELEG) & BIT(trap->cause))) {
 			next_virt = TRUE;
@@ -120,7 +129,7 @@ int sbi_trap_redirect(struct sbi_trap_regs *regs,
 #endif
 
 	/* Update hypervisor CSRs if going to HS-mode */
-	if (misa_extension('H') && !next_virt) {
+	if ((sbi_hart_fast_flags() & SBI_HART_FAST_HEXT) && !next_virt) {
 		hstatus = csr_read(CSR_HSTATUS);
 		if (prev_virt) {
 			/* hstatus.SPVP is only updated if coming from VS/VU-mode */
@@ -244,6 +253,22 @@ static int sbi_trap_aia_irq(struct sbi_trap_regs *regs, ulong mcause)
 	return 0;
 }
 
+static int sbi_trap_irq(struct sbi_trap_regs *regs, ulong mcause)
+{
+	int rc;
+	u64 sta_start = sbi_sta_irq_enter(regs);
+
+	if (sbi_hart_fast_flags() & SBI_HART_FAST_SMAIA)
+		rc = sbi_trap_aia_irq(regs, mcause);
+	else
+		rc = sbi_trap_nonaia_irq(regs, mcause);
+
+	/* Time spent in M-mode interrupt handling is stolen from S-mode */
+	sbi_sta_irq_exit(sta_start);
+
+	return rc;
+}
+
 /**
  * Handle trap/interrupt
  *
@@ -264,25 +289,23 @@ struct sbi_trap_regs *sbi_trap_handler(struct sbi_trap_regs *regs)
 {
 	int rc = SBI_ENOTSUPP;
 	const char *msg = "trap handler failed";
+	ulong stats_start = sbi_trap_stats_start();
 	ulong mcause = csr_read(CSR_MCAUSE);
 	ulong mtval = csr_read(CSR_MTVAL), mtval2 = 0, mtinst = 0;
 	struct sbi_trap_info trap;
 
-	if (misa_extension('H')) {
+	if (sbi_hart_fast_flags() & SBI_HART_FAST_HEXT) {
 		mtval2 = csr_read(CSR_MTVAL2);
 		mtinst = csr_read(CSR_MTINST);
 	}
 
 	if (mcause & (1UL << (__riscv_xlen - 1))) {
-		if (sbi_hart_has_extension(sbi_scratch_thishart_ptr(),
-					   SBI_HART_EXT_SMAIA))
-			rc = sbi_trap_aia_irq(regs, mcause);
-		else
-			rc = sbi_trap_nonaia_irq(regs, mcause);
+		rc = sbi_trap_irq(regs, mcause);
 		if (rc) {
 			msg = "unhandled local interrupt";
 			goto trap_error;
 		}
+		sbi_trap_stats_record_trap(mcause, stats_start);
 		return regs;
 	}
 
@@ -324,7 +347,44 @@ struct sbi_trap_regs *sbi_trap_handler(struct sbi_trap_regs *regs)
 
 trap_error:
 	if (rc)
-		sbi_trap_error(msg, rc, mcause, mtval, mtval2, mtinst, regs);
+		sbi_trap_error(msg, rc, mcause, mtval, mtval2, mtinst,
+			       regs, TRUE);
+	sbi_trap_stats_record_trap(mcause, stats_start);
+	return regs;
+}
+
+/**
+ * Handle frequent trap/interrupt on the fast path
+ *
+ * This function is called by firmware linked to OpenSBI
+ * library only for M-mode timer and software interrupts and for
+ * TIME, IPI and legacy SET_TIMER ecalls from S-mode. It has the
+ * same expectations as sbi_trap_handler() except that only the
+ * caller-saved registers, MEPC and MSTATUS are valid in the
+ * register state so it must not be used to access or modify any
+ * callee-saved register.
+ *
+ * @param regs pointer to register state
+ */
+struct sbi_trap_regs *sbi_trap_handler_fast(struct sbi_trap_regs *regs)
+{
+	int rc;
+	const char *msg;
+	ulong stats_start = sbi_trap_stats_start();
+	ulong mcause = csr_read(CSR_MCAUSE);
+
+	if (mcause & (1UL << (__riscv_xlen - 1))) {
+		rc = sbi_trap_irq(regs, mcause);
+		msg = "unhandled local interrupt";
+	} else {
+		rc = sbi_ecall_handler(regs);
+		msg = "ecall handler failed";
+	}
+
+	if (rc)
+		sbi_trap_error(msg, rc, mcause, csr_read(CSR_MTVAL),
+			       0, 0, regs, FALSE);
+	sbi_trap_stats_record_trap(mcause, stats_start);
 	return regs;
 }
 
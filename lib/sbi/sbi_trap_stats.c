@@ -0,0 +1,209 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ */
+
+#include <sbi/riscv_asm.h>
+#include <sbi/sbi_bitops.h>
+#include <sbi/sbi_console.h>
+#include <sbi/sbi_ecall.h>
+#include <sbi/sbi_error.h>
+#include <sbi/sbi_scratch.h>
+#include <sbi/sbi_string.h>
+#include <sbi/sbi_trap_stats.h>
+
+#define TRAP_STATS_MAX_HARTS		CONFIG_SBI_TRAP_STATS_MAX_HARTS
+
+/* Exception causes 0 - 23 followed by interrupt causes 0 - 15 */
+#define TRAP_STATS_NR_EXCEPTIONS	24
+#define TRAP_STATS_NR_INTERRUPTS	16
+#define TRAP_STATS_NR_CAUSES		\
+	(TRAP_STATS_NR_EXCEPTIONS + TRAP_STATS_NR_INTERRUPTS)
+
+/* Function IDs above this are accounted in the last function slot */
+#define TRAP_STATS_NR_FUNCS		8
+
+/*
+ * Histogram buckets of M-mode cycles: <256, <1K, <4K, <16K, <64K,
+ * <256K, <1M and >=1M
+ */
+#define TRAP_STATS_NR_BUCKETS		8
+
+struct trap_stats_entry {
+	u64 count;
+	u64 cycles;
+	u32 hist[TRAP_STATS_NR_BUCKETS];
+};
+
+struct trap_stats_func {
+	u64 count;
+	u64 cycles;
+};
+
+struct trap_stats_hart {
+	struct trap_stats_entry cause[TRAP_STATS_NR_CAUSES];
+	struct trap_stats_entry ecall[SBI_ECALL_MAX_EXTENSIONS];
+	struct trap_stats_func func[SBI_ECALL_MAX_EXTENSIONS]
+				   [TRAP_STATS_NR_FUNCS];
+};
+
+static struct trap_stats_hart trap_stats[TRAP_STATS_MAX_HARTS];
+
+/* Extension registered in each ecall slot when it was last recorded */
+static const struct sbi_ecall_extension *
+trap_stats_ext[SBI_ECALL_MAX_EXTENSIONS];
+
+static int trap_stats_cause_index(ulong mcause)
+{
+	ulong code = mcause & ~(1UL << (__riscv_xlen - 1));
+
+	if (mcause & (1UL << (__riscv_xlen - 1)))
+		return (code < TRAP_STATS_NR_INTERRUPTS) ?
+			TRAP_STATS_NR_EXCEPTIONS + code : -1;
+
+	return (code < TRAP_STATS_NR_EXCEPTIONS) ? code : -1;
+}
+
+static void trap_stats_add(struct trap_stats_entry *e, ulong cycles)
+{
+	ulong bucket = 0;
+
+	if (cycles >= 256) {
+		bucket = (sbi_fls(cycles) - 6) / 2;
+		if (bucket >= TRAP_STATS_NR_BUCKETS)
+			bucket = TRAP_STATS_NR_BUCKETS - 1;
+	}
+
+	e->count++;
+	e->cycles += cycles;
+	e->hist[bucket]++;
+}
+
+static inline struct trap_stats_hart *trap_stats_thishart(void)
+{
+	u32 hartid = current_hartid();
+
+	return (hartid < TRAP_STATS_MAX_HARTS) ? &trap_stats[hartid] : NULL;
+}
+
+void sbi_trap_stats_record_trap(ulong mcause, ulong start)
+{
+	ulong cycles = csr_read(CSR_MCYCLE) - start;
+	struct trap_stats_hart *ts = trap_stats_thishart();
+	int idx = trap_stats_cause_index(mcause);
+
+	if (ts && idx >= 0)
+		trap_stats_add(&ts->cause[idx], cycles);
+}
+
+void sbi_trap_stats_record_ecall(int slot,
+				 const struct sbi_ecall_extension *ext,
+				 ulong funcid, ulong start)
+{
+	ulong cycles = csr_read(CSR_MCYCLE) - start;
+	struct trap_stats_hart *ts = trap_stats_thishart();
+	struct trap_stats_func *f;
+
+	if (!ts || slot < 0 || slot >= SBI_ECALL_MAX_EXTENSIONS)
+		return;
+
+	trap_stats_ext[slot] = ext;
+	trap_stats_add(&ts->ecall[slot], cycles);
+
+	if (funcid >= TRAP_STATS_NR_FUNCS)
+		funcid = TRAP_STATS_NR_FUNCS - 1;
+	f = &ts->func[slot][funcid];
+	f->count++;
+	f->cycles += cycles;
+}
+
+int sbi_trap_stats_read(u32 hartid, ulong mcause, ulong field,
+			unsigned long *out_val)
+{
+	int idx = trap_stats_cause_index(mcause);
+	struct trap_stats_entry *e;
+
+	if (hartid >= TRAP_STATS_MAX_HARTS || idx < 0)
+		return SBI_EINVAL;
+
+	e = &trap_stats[hartid].cause[idx];
+	switch (field) {
+	case SBI_TRAP_STATS_FIELD_COUNT:
+		*out_val = e->count;
+		break;
+	case SBI_TRAP_STATS_FIELD_CYCLES:
+		*out_val = e->cycles;
+		break;
+	default:
+		return SBI_EINVAL;
+	}
+
+	return 0;
+}
+
+void sbi_trap_stats_reset(void)
+{
+	sbi_memset(trap_stats, 0, sizeof(trap_stats));
+}
+
+static void trap_stats_print(const char *prefix, ulong id,
+			     const struct trap_stats_entry *e)
+{
+	int i;
+
+	sbi_printf("  %-5s 0x%08lx count %10llu avg %8llu cycles |",
+		   prefix, id, (unsigned long long)e->count,
+		   (unsigned long long)(e->cycles / e->count));
+	for (i = 0; i < TRAP_STATS_NR_BUCKETS; i++)
+		sbi_printf(" %u", e->hist[i]);
+	sbi_printf("\n");
+}
+
+void sbi_trap_stats_dump(void)
+{
+	u32 hartid, i, j;
+	struct trap_stats_hart *ts;
+	struct trap_stats_func *f;
+
+	sbi_printf("Trap statistics (histogram: <256 <1K <4K <16K <64K "
+		   "<256K <1M >=1M cycles)\n");
+
+	for (hartid = 0; hartid < TRAP_STATS_MAX_HARTS; hartid++) {
+		if (!sbi_hartid_to_scratch(hartid))
+			continue;
+
+		ts = &trap_stats[hartid];
+		sbi_printf("HART%u:\n", hartid);
+
+		for (i = 0; i < TRAP_STATS_NR_CAUSES; i++) {
+			if (!ts->cause[i].count)
+				continue;
+			if (i < TRAP_STATS_NR_EXCEPTIONS)
+				trap_stats_print("exc", i, &ts->cause[i]);
+			else
+				trap_stats_print("irq",
+					i - TRAP_STATS_NR_EXCEPTIONS,
+					&ts->cause[i]);
+		}
+
+		for (i = 0; i < SBI_ECALL_MAX_EXTENSIONS; i++) {
+			if (!ts->ecall[i].count || !trap_stats_ext[i])
+				continue;
+			trap_stats_print("ecall", trap_stats_ext[i]->extid_start,
+					 &ts->ecall[i]);
+			for (j = 0; j < TRAP_STATS_NR_FUNCS; j++) {
+				f = &ts->func[i][j];
+				if (!f->count)
+					continue;
+				sbi_printf("    fid %s%u count %10llu "
+					   "avg %8llu cycles\n",
+					   (j == TRAP_STATS_NR_FUNCS - 1) ?
+					   ">=" : "", j,
+					   (unsigned long long)f->count,
+					   (unsigned long long)
+					   (f->cycles / f->count));
+			}
+		}
+	}
+}
@@ -116,6 +116,95 @@ void sbi_store_u64(u64 *addr, u64 val,
 # error "Unexpected __riscv_xlen"
 #endif
 
+/*
+ * The expected trap handler overwrites a4 with a non-zero value so a4
+ * is cleared before the MPRV window and checked after every access.
+ * This allows several accesses in one MPRV window and stops at the
+ * first one which traps. The faulting access must not be compressed
+ * because the expected trap handler skips 4 bytes.
+ */
+ulong sbi_load_bytes(const u8 *addr, ulong len, ulong *val,
+		     struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3");
+	register ulong ttmp asm("a4") = 0;
+	register ulong mstatus = 0;
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+	ulong i = 0, ret = 0, tmp, shift;
+
+	trap->cause = 0;
+	if (len > sizeof(ulong))
+		len = sizeof(ulong);
+
+	asm volatile(
+	    "add %[tinfo], %[taddr], zero\n"
+	    "csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+	    "csrrs %[mstatus], " STR(CSR_MSTATUS) ", %[mprv]\n"
+	    "1: bgeu %[i], %[len], 2f\n"
+	    "add %[tmp], %[addr], %[i]\n"
+	    ".option push\n"
+	    ".option norvc\n"
+	    "lbu %[tmp], 0(%[tmp])\n"
+	    ".option pop\n"
+	    "bnez %[ttmp], 2f\n"
+	    "slli %[shift], %[i], 3\n"
+	    "sll %[tmp], %[tmp], %[shift]\n"
+	    "or %[ret], %[ret], %[tmp]\n"
+	    "addi %[i], %[i], 1\n"
+	    "j 1b\n"
+	    "2: csrw " STR(CSR_MSTATUS) ", %[mstatus]\n"
+	    "csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mstatus] "+&r"(mstatus), [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp), [i] "+&r"(i),
+	      [ret] "+&r"(ret), [tmp] "=&r"(tmp), [shift] "=&r"(shift)
+	    : [mprv] "r"(MSTATUS_MPRV), [taddr] "r"((ulong)trap),
+	      [addr] "r"((ulong)addr), [len] "r"(len)
+	    : "memory");
+
+	*val = ret;
+	return i;
+}
+
+ulong sbi_store_bytes(u8 *addr, ulong len, ulong val,
+		      struct sbi_trap_info *trap)
+{
+	register ulong tinfo asm("a3");
+	register ulong ttmp asm("a4") = 0;
+	register ulong mstatus = 0;
+	register ulong mtvec = sbi_hart_expected_trap_addr();
+	ulong i = 0, tmp, ptr;
+
+	trap->cause = 0;
+	if (len > sizeof(ulong))
+		len = sizeof(ulong);
+
+	asm volatile(
+	    "add %[tinfo], %[taddr], zero\n"
+	    "csrrw %[mtvec], " STR(CSR_MTVEC) ", %[mtvec]\n"
+	    "csrrs %[mstatus], " STR(CSR_MSTATUS) ", %[mprv]\n"
+	    "1: bgeu %[i], %[len], 2f\n"
+	    "slli %[tmp], %[i], 3\n"
+	    "srl %[tmp], %[val], %[tmp]\n"
+	    "add %[ptr], %[addr], %[i]\n"
+	    ".option push\n"
+	    ".option norvc\n"
+	    "sb %[tmp], 0(%[ptr])\n"
+	    ".option pop\n"
+	    "bnez %[ttmp], 2f\n"
+	    "addi %[i], %[i], 1\n"
+	    "j 1b\n"
+	    "2: csrw " STR(CSR_MSTATUS) ", %[mstatus]\n"
+	    "csrw " STR(CSR_MTVEC) ", %[mtvec]"
+	    : [mstatus] "+&r"(mstatus), [mtvec] "+&r"(mtvec),
+	      [tinfo] "+&r"(tinfo), [ttmp] "+&r"(ttmp), [i] "+&r"(i),
+	      [tmp] "=&r"(tmp), [ptr] "=&r"(ptr)
+	    : [mprv] "r"(MSTATUS_MPRV), [taddr] "r"((ulong)trap),
+	      [addr] "r"((ulong)addr), [len] "r"(len), [val] "r"(val)
+	    : "memory");
+
+	return i;
+}
+
 ulong sbi_get_insn(ulong mepc, struct sbi_trap_info *trap)
 {
 	register ulong tinfo asm("a3");
@@ -9,6 +9,7 @@
 
 #include <sbi/riscv_asm.h>
 #include <sbi/riscv_atomic.h>
+#include <sbi/riscv_barrier.h>
 #include <sbi/riscv_io.h>
 #include <sbi/sbi_domain.h>
 #include <sbi/sbi_error.h>
@@ -35,6 +36,25 @@ static void mswi_ipi_send(u32 target_hart)
 	writel(1, &msip[target_hart - mswi->first_hartid]);
 }
 
+static void mswi_ipi_send_mask(const struct sbi_hartmask *target_mask)
+{
+	u32 *msip, i;
+	struct aclint_mswi_data *mswi;
+
+	/* Order prior memory writes before all ACLINT IPI writes */
+	wmb();
+
+	sbi_hartmask_for_each_hart(i, target_mask) {
+		mswi = mswi_hartid2data[i];
+		if (!mswi)
+			continue;
+
+		/* Set ACLINT IPI */
+		msip = (void *)mswi->addr;
+		writel_relaxed(1, &msip[i - mswi->first_hartid]);
+	}
+}
+
 static void mswi_ipi_clear(u32 target_hart)
 {
 	u32 *msip;
@@ -54,6 +74,7 @@ static void mswi_ipi_clear(u32 target_hart)
 static struct sbi_ipi_device aclint_mswi = {
 	.name = "aclint-mswi",
 	.ipi_send = mswi_ipi_send,
+	.ipi_send_mask = mswi_ipi_send_mask,
 	.ipi_clear = mswi_ipi_clear
 };
 
@@ -40,6 +40,13 @@ static inline void plicsw_complete(void)
 			       PLICSW_CONTEXT_STRIDE * hartid);
 }
 
+static inline u32 plic_sw_pending_val(u32 target_hart)
+{
+	u32 per_hart_offset = PLICSW_PENDING_STRIDE * current_hartid();
+
+	return 1 << target_hart << per_hart_offset;
+}
+
 static inline void plic_sw_pending(u32 target_hart)
 {
 	/*
@@ -62,8 +69,7 @@ static inline void plic_sw_pending(u32 target_hart)
 	 */
 	u32 hartid	    = current_hartid();
 	u32 word_index	    = hartid / 4;
-	u32 per_hart_offset = PLICSW_PENDING_STRIDE * hartid;
-	u32 val		    = 1 << target_hart << per_hart_offset;
+	u32 val		    = plic_sw_pending_val(target_hart);
 
 	writel(val, (void *)plicsw.addr + PLICSW_PENDING_BASE + word_index * 4);
 }
@@ -77,6 +83,26 @@ static void plicsw_ipi_send(u32 target_hart)
 	plic_sw_pending(target_hart);
 }
 
+static void plicsw_ipi_send_mask(const struct sbi_hartmask *target_mask)
+{
+	u32 i, val = 0;
+	u32 word_index = current_hartid() / 4;
+
+	/*
+	 * All target HARTs are bits in the pending region of the
+	 * current HART so set them using a single write.
+	 */
+	sbi_hartmask_for_each_hart(i, target_mask) {
+		if (plicsw.hart_count <= i)
+			ebreak();
+		val |= plic_sw_pending_val(i);
+	}
+
+	if (val)
+		writel(val, (void *)plicsw.addr + PLICSW_PENDING_BASE +
+			    word_index * 4);
+}
+
 static void plicsw_ipi_clear(u32 target_hart)
 {
 	if (plicsw.hart_count <= target_hart)
@@ -90,6 +116,7 @@ static void plicsw_ipi_clear(u32 target_hart)
 static struct sbi_ipi_device plicsw_ipi = {
 	.name      = "andes_plicsw",
 	.ipi_send  = plicsw_ipi_send,
+	.ipi_send_mask = plicsw_ipi_send_mask,
 	.ipi_clear = plicsw_ipi_clear
 };
 
@@ -57,6 +57,61 @@ void fdt_plic_context_restore(bool smode, const u32 *enable, u32 threshold,
 			     enable, threshold, num);
 }
 
+/* Maximum number of interrupt sources of a PLIC */
+#define PLIC_MAX_NR_SRC			1023
+#define PLIC_MAX_IE_WORDS		(PLIC_MAX_NR_SRC / 32 + 1)
+
+/* PLIC state of the HART suspending the system */
+static u8 plic_suspend_priority[PLIC_MAX_NR_SRC + 1];
+static u32 plic_suspend_enable[2][PLIC_MAX_IE_WORDS];
+static u32 plic_suspend_threshold[2];
+
+void fdt_plic_suspend(void)
+{
+	int i;
+	u32 hartid = current_hartid();
+	struct plic_data *plic = plic_hartid2data[hartid];
+
+	if (!plic)
+		return;
+
+	plic_priority_save(plic, plic_suspend_priority,
+			   (plic->num_src < PLIC_MAX_NR_SRC) ?
+			   plic->num_src : PLIC_MAX_NR_SRC);
+
+	for (i = 0; i < 2; i++) {
+		if (plic_hartid2context[hartid][i] < 0)
+			continue;
+		plic_context_save(plic, plic_hartid2context[hartid][i],
+				  plic_suspend_enable[i],
+				  &plic_suspend_threshold[i],
+				  PLIC_MAX_IE_WORDS);
+	}
+}
+
+void fdt_plic_resume(void)
+{
+	int i;
+	u32 hartid = current_hartid();
+	struct plic_data *plic = plic_hartid2data[hartid];
+
+	if (!plic)
+		return;
+
+	plic_priority_restore(plic, plic_suspend_priority,
+			      (plic->num_src < PLIC_MAX_NR_SRC) ?
+			      plic->num_src : PLIC_MAX_NR_SRC);
+
+	for (i = 0; i < 2; i++) {
+		if (plic_hartid2context[hartid][i] < 0)
+			continue;
+		plic_context_restore(plic, plic_hartid2context[hartid][i],
+				     plic_suspend_enable[i],
+				     plic_suspend_threshold[i],
+				     PLIC_MAX_IE_WORDS);
+	}
+}
+
 static int irqchip_plic_warm_init(void)
 {
 	u32 hartid = current_hartid();
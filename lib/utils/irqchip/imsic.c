@@ -9,6 +9,7 @@
  */
 
 #include <sbi/riscv_asm.h>
+#include <sbi/riscv_barrier.h>
 #include <sbi/riscv_io.h>
 #include <sbi/riscv_encoding.h>
 #include <sbi/sbi_console.h>
@@ -129,7 +130,7 @@ static int imsic_external_irqfn(struct sbi_trap_regs *regs)
 	return 0;
 }
 
-static void imsic_ipi_send(u32 target_hart)
+static void *imsic_ipi_addr(u32 target_hart)
 {
 	unsigned long reloff;
 	struct imsic_regs *regs;
@@ -137,7 +138,7 @@ static void imsic_ipi_send(u32 target_hart)
 	int file = imsic_hartid2file[target_hart];
 
 	if (!data || !data->targets_mmode)
-		return;
+		return NULL;
 
 	regs = &data->regs[0];
 	reloff = file * (1UL << data->guest_index_bits) * IMSIC_MMIO_PAGE_SZ;
@@ -147,13 +148,38 @@ static void imsic_ipi_send(u32 target_hart)
 	}
 
 	if (regs->size && (reloff < regs->size))
-		writel(IMSIC_IPI_ID,
-		       (void *)(regs->addr + reloff + IMSIC_MMIO_PAGE_LE));
+		return (void *)(regs->addr + reloff + IMSIC_MMIO_PAGE_LE);
+
+	return NULL;
+}
+
+static void imsic_ipi_send(u32 target_hart)
+{
+	void *addr = imsic_ipi_addr(target_hart);
+
+	if (addr)
+		writel(IMSIC_IPI_ID, addr);
+}
+
+static void imsic_ipi_send_mask(const struct sbi_hartmask *target_mask)
+{
+	u32 i;
+	void *addr;
+
+	/* Order prior memory writes before all IMSIC IPI writes */
+	wmb();
+
+	sbi_hartmask_for_each_hart(i, target_mask) {
+		addr = imsic_ipi_addr(i);
+		if (addr)
+			writel_relaxed(IMSIC_IPI_ID, addr);
+	}
 }
 
 static struct sbi_ipi_device imsic_ipi_device = {
 	.name		= "aia-imsic",
-	.ipi_send	= imsic_ipi_send
+	.ipi_send	= imsic_ipi_send,
+	.ipi_send_mask	= imsic_ipi_send_mask
 };
 
 static void imsic_local_eix_update(unsigned long base_id,
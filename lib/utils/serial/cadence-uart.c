@@ -74,6 +74,23 @@ static void cadence_uart_putc(char ch)
 	set_reg(UART_REG_RFIFO_TFIFO, ch);
 }
 
+static unsigned long cadence_uart_puts(const char *str, unsigned long len)
+{
+	unsigned long i = 0;
+
+	/* Fill the transmit FIFO until it is full */
+	while (i < len) {
+		if (get_reg(UART_REG_CSR) & UART_CSR_TFUL) {
+			if (i)
+				break;
+			continue;
+		}
+		set_reg(UART_REG_RFIFO_TFIFO, str[i++]);
+	}
+
+	return i;
+}
+
 static int cadence_uart_getc(void)
 {
 	u32 ret = get_reg(UART_REG_CSR);
@@ -87,6 +104,7 @@ static int cadence_uart_getc(void)
 static struct sbi_console_device cadence_console = {
 	.name = "cadence_uart",
 	.console_putc = cadence_uart_putc,
+	.console_puts = cadence_uart_puts,
 	.console_getc = cadence_uart_getc
 };
 
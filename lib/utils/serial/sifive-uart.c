@@ -74,6 +74,23 @@ static void sifive_uart_putc(char ch)
 	set_reg(UART_REG_TXFIFO, ch);
 }
 
+static unsigned long sifive_uart_puts(const char *str, unsigned long len)
+{
+	unsigned long i = 0;
+
+	/* Fill the transmit FIFO until it is full */
+	while (i < len) {
+		if (get_reg(UART_REG_TXFIFO) & UART_TXFIFO_FULL) {
+			if (i)
+				break;
+			continue;
+		}
+		set_reg(UART_REG_TXFIFO, str[i++]);
+	}
+
+	return i;
+}
+
 static int sifive_uart_getc(void)
 {
 	u32 ret = get_reg(UART_REG_RXFIFO);
@@ -87,6 +104,7 @@ static int sifive_uart_getc(void)
 static struct sbi_console_device sifive_console = {
 	.name = "sifive_uart",
 	.console_putc = sifive_uart_putc,
+	.console_puts = sifive_uart_puts,
 	.console_getc = sifive_uart_getc
 };
 
@@ -13,11 +13,13 @@
 #include <sbi/sbi_hartmask.h>
 #include <sbi/sbi_platform.h>
 #include <sbi/sbi_string.h>
+#include <sbi/sbi_system.h>
 #include <sbi_utils/fdt/fdt_domain.h>
 #include <sbi_utils/fdt/fdt_fixup.h>
 #include <sbi_utils/fdt/fdt_helper.h>
 #include <sbi_utils/fdt/fdt_pmu.h>
 #include <sbi_utils/irqchip/fdt_irqchip.h>
+#include <sbi_utils/irqchip/fdt_irqchip_plic.h>
 #include <sbi_utils/irqchip/imsic.h>
 #include <sbi_utils/serial/fdt_serial.h>
 #include <sbi_utils/timer/fdt_timer.h>
@@ -137,14 +139,56 @@ static int generic_early_init(bool cold_boot)
 	return generic_plat->early_init(cold_boot, generic_plat_match);
 }
 
+static int generic_system_suspend_check(u32 sleep_type)
+{
+	if (generic_plat->system_suspend_check)
+		return generic_plat->system_suspend_check(sleep_type,
+							  generic_plat_match);
+
+	return sleep_type == SBI_SUSP_SLEEP_TYPE_SUSPEND;
+}
+
+static int generic_system_suspend(u32 sleep_type,
+				  unsigned long mmode_resume_addr)
+{
+	int rc;
+
+	/* The PLIC loses its state in suspend-to-RAM */
+	fdt_plic_suspend();
+
+	rc = generic_plat->system_suspend(sleep_type, mmode_resume_addr,
+					  generic_plat_match);
+	if (rc)
+		fdt_plic_resume();
+
+	return rc;
+}
+
+static void generic_system_resume(void)
+{
+	fdt_plic_resume();
+}
+
+static struct sbi_system_suspend_device generic_suspend = {
+	.name = "generic",
+	.system_suspend_check = generic_system_suspend_check,
+	.system_suspend = generic_system_suspend,
+	.system_resume = generic_system_resume,
+};
+
 static int generic_final_init(bool cold_boot)
 {
 	void *fdt;
 	int rc;
 
-	if (cold_boot)
+	if (cold_boot) {
 		fdt_reset_init();
 
+		/* Platform overrides provide the suspend-to-RAM sequence */
+		if (generic_plat && generic_plat->system_suspend)
+			sbi_system_suspend_set_device(&generic_suspend);
+	}
+
 	if (generic_plat && generic_plat->final_init) {
 		rc = generic_plat->final_init(cold_boot, generic_plat_match);
 		if (rc)
@@ -225,6 +269,13 @@ static u64 generic_tlbr_flush_limit(void)
 	return SBI_PLATFORM_TLB_RANGE_FLUSH_LIMIT_DEFAULT;
 }
 
+static u32 generic_tlb_num_entries(void)
+{
+	if (generic_plat && generic_plat->tlb_num_entries)
+		return generic_plat->tlb_num_entries(generic_plat_match);
+	return SBI_PLATFORM_TLB_NUM_ENTRIES_DEFAULT;
+}
+
 static int generic_pmu_init(void)
 {
 	return fdt_pmu_setup(fdt_get_address());
@@ -276,6 +327,7 @@ const struct sbi_platform_operations platform_ops = {
 	.pmu_init		= generic_pmu_init,
 	.pmu_xlate_to_mhpmevent = generic_pmu_xlate_to_mhpmevent,
 	.get_tlbr_flush_limit	= generic_tlbr_flush_limit,
+	.get_tlb_num_entries	= generic_tlb_num_entries,
 	.timer_init		= fdt_timer_init,
 	.timer_exit		= fdt_timer_exit,
 	.vendor_ext_check	= generic_vendor_ext_check,
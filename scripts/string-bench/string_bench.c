@@ -0,0 +1,272 @@
+/*
+ * SPDX-License-Identifier: BSD-2-Clause
+ *
+ * Copyright (c) 2026 OpenSBI Contributors
+ *
+ * Host micro-benchmark of the word-sized sbi_mem*() functions against
+ * the byte-wise versions they replaced. Every case is also checked
+ * against the byte-wise result.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Functions under test from lib/sbi/sbi_string.c */
+void *sbi_memset(void *s, int c, size_t count);
+void *sbi_memcpy(void *dest, const void *src, size_t count);
+void *sbi_memmove(void *dest, const void *src, size_t count);
+int sbi_memcmp(const void *s1, const void *s2, size_t count);
+
+/*
+ * Byte-wise versions previously in lib/sbi/sbi_string.c, kept out of
+ * line like the functions under test
+ */
+#define __bench_noinline	__attribute__((noinline))
+
+static __bench_noinline void *byte_memset(void *s, int c, size_t count)
+{
+	char *temp = s;
+
+	while (count > 0) {
+		count--;
+		*temp++ = c;
+	}
+
+	return s;
+}
+
+static __bench_noinline void *byte_memcpy(void *dest, const void *src, size_t count)
+{
+	char *temp1 = dest;
+	const char *temp2 = src;
+
+	while (count > 0) {
+		*temp1++ = *temp2++;
+		count--;
+	}
+
+	return dest;
+}
+
+static __bench_noinline void *byte_memmove(void *dest, const void *src, size_t count)
+{
+	char *temp1 = (char *)dest;
+	const char *temp2 = (char *)src;
+
+	if (src == dest)
+		return dest;
+
+	if (dest < src) {
+		while (count > 0) {
+			*temp1++ = *temp2++;
+			count--;
+		}
+	} else {
+		temp1 = dest + count - 1;
+		temp2 = src + count - 1;
+
+		while (count > 0) {
+			*temp1-- = *temp2--;
+			count--;
+		}
+	}
+
+	return dest;
+}
+
+static __bench_noinline int byte_memcmp(const void *s1, const void *s2, size_t count)
+{
+	const char *temp1 = s1;
+	const char *temp2 = s2;
+
+	for (; count > 0 && (*temp1 == *temp2); count--) {
+		temp1++;
+		temp2++;
+	}
+
+	if (count > 0)
+		return *(unsigned char *)temp1 - *(unsigned char *)temp2;
+	else
+		return 0;
+}
+
+#define BENCH_BUF_SIZE		(64 * 1024)
+#define BENCH_BYTES_PER_CASE	(64UL * 1024 * 1024)
+#define BENCH_CHECK_ROUNDS	100000
+
+static unsigned char src_buf[BENCH_BUF_SIZE + 64];
+static unsigned char dst_buf[BENCH_BUF_SIZE + 64];
+static unsigned char ref_buf[BENCH_BUF_SIZE + 64];
+static volatile int bench_sink;
+
+enum bench_op {
+	BENCH_MEMSET,
+	BENCH_MEMCPY,
+	BENCH_MEMMOVE,
+	BENCH_MEMCMP,
+	BENCH_OP_MAX,
+};
+
+static const char *bench_op_names[BENCH_OP_MAX] = {
+	"memset", "memcpy", "memmove", "memcmp",
+};
+
+static double now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void run_op(enum bench_op op, int word, unsigned char *d,
+		   unsigned char *s, size_t len)
+{
+	switch (op) {
+	case BENCH_MEMSET:
+		(word) ? sbi_memset(d, 0x5a, len) : byte_memset(d, 0x5a, len);
+		break;
+	case BENCH_MEMCPY:
+		(word) ? sbi_memcpy(d, s, len) : byte_memcpy(d, s, len);
+		break;
+	case BENCH_MEMMOVE:
+		/* Overlapping move towards higher addresses */
+		(word) ? sbi_memmove(d + 8, s, len) :
+			 byte_memmove(d + 8, s, len);
+		break;
+	case BENCH_MEMCMP:
+		bench_sink += (word) ? sbi_memcmp(d, s, len) :
+				       byte_memcmp(d, s, len);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Returns nanoseconds per byte */
+static double bench_case(enum bench_op op, int word, size_t len,
+			 size_t dalign, size_t salign)
+{
+	size_t i, iters = BENCH_BYTES_PER_CASE / len;
+	unsigned char *d = dst_buf + dalign, *s = src_buf + salign;
+	double start;
+
+	/* memmove() source overlaps the destination */
+	if (op == BENCH_MEMMOVE)
+		s = dst_buf + salign;
+
+	/* memcmp() of equal buffers has to scan all bytes */
+	if (op == BENCH_MEMCMP)
+		memcpy(d, s, len);
+
+	start = now_ns();
+	for (i = 0; i < iters; i++)
+		run_op(op, word, d, s, len);
+
+	return (now_ns() - start) / (iters * len);
+}
+
+static int sign(int v)
+{
+	return (v > 0) - (v < 0);
+}
+
+/* Compare the word-sized functions with the byte-wise ones */
+static int check(void)
+{
+	size_t i, len, dalign, salign, off;
+	int r1, r2;
+
+	srand(1);
+	for (i = 0; i < sizeof(src_buf); i++)
+		src_buf[i] = rand();
+
+	for (i = 0; i < BENCH_CHECK_ROUNDS; i++) {
+		len = rand() % 512;
+		dalign = rand() % 16;
+		salign = rand() % 16;
+		off = rand() % 32;
+
+		memcpy(dst_buf, src_buf + 64, sizeof(dst_buf) - 64);
+		memcpy(ref_buf, dst_buf, sizeof(ref_buf));
+
+		switch (i % BENCH_OP_MAX) {
+		case BENCH_MEMSET:
+			sbi_memset(dst_buf + dalign, i, len);
+			byte_memset(ref_buf + dalign, i, len);
+			break;
+		case BENCH_MEMCPY:
+			sbi_memcpy(dst_buf + dalign, src_buf + salign, len);
+			byte_memcpy(ref_buf + dalign, src_buf + salign, len);
+			break;
+		case BENCH_MEMMOVE:
+			sbi_memmove(dst_buf + dalign + off, dst_buf + dalign,
+				    len);
+			byte_memmove(ref_buf + dalign + off, ref_buf + dalign,
+				     len);
+			sbi_memmove(dst_buf + dalign, dst_buf + dalign + off,
+				    len);
+			byte_memmove(ref_buf + dalign, ref_buf + dalign + off,
+				     len);
+			break;
+		case BENCH_MEMCMP:
+			if (len && (rand() & 1))
+				dst_buf[dalign + rand() % len] ^= 1 << (rand() % 8);
+			memcpy(ref_buf, dst_buf, sizeof(ref_buf));
+			r1 = sbi_memcmp(dst_buf + dalign, src_buf + salign, len);
+			r2 = byte_memcmp(dst_buf + dalign, src_buf + salign, len);
+			if (sign(r1) != sign(r2)) {
+				printf("FAIL: memcmp len %zu align %zu/%zu\n",
+				       len, dalign, salign);
+				return 1;
+			}
+			break;
+		default:
+			break;
+		}
+
+		if (memcmp(dst_buf, ref_buf, sizeof(ref_buf))) {
+			printf("FAIL: %s len %zu align %zu/%zu\n",
+			       bench_op_names[i % BENCH_OP_MAX],
+			       len, dalign, salign);
+			return 1;
+		}
+	}
+
+	printf("Checked %d randomized cases against the byte-wise versions\n\n",
+	       BENCH_CHECK_ROUNDS);
+	return 0;
+}
+
+int main(void)
+{
+	static const size_t lens[] = { 16, 64, 256, 4096, 65536 - 64 };
+	static const size_t aligns[][2] = { { 0, 0 }, { 3, 3 }, { 1, 2 } };
+	double byte_ns, word_ns;
+	size_t l, a;
+	int op;
+
+	if (check())
+		return 1;
+
+	printf("%-8s %6s %9s %12s %12s %8s\n", "func", "len", "dst/src",
+	       "byte ns/B", "word ns/B", "speedup");
+	for (op = 0; op < BENCH_OP_MAX; op++) {
+		for (l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+			for (a = 0; a < sizeof(aligns) / sizeof(aligns[0]); a++) {
+				byte_ns = bench_case(op, 0, lens[l],
+						     aligns[a][0], aligns[a][1]);
+				word_ns = bench_case(op, 1, lens[l],
+						     aligns[a][0], aligns[a][1]);
+				printf("%-8s %6zu %5zu/%-3zu %12.4f %12.4f %7.2fx\n",
+				       bench_op_names[op], lens[l],
+				       aligns[a][0], aligns[a][1],
+				       byte_ns, word_ns, byte_ns / word_ns);
+			}
+		}
+	}
+
+	return 0;
+}